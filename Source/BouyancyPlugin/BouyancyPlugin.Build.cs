@@ -27,6 +27,8 @@ public class BouyancyPlugin : ModuleRules
 			{
 				"Core",
 				"Water",
+				"MassEntity",
+				"MassSpawner",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -39,6 +41,8 @@ public class BouyancyPlugin : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"MassCommon",
+				"StructUtils",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,208 @@
+#include "BuoyancyMassProcessor.h"
+#include "BuoyancyMassFragments.h"
+#include "BuoyancyMath.h"
+#include "BuoyancyWaterSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+
+UBuoyancyMassProcessor::UBuoyancyMassProcessor()
+    : EntityQuery(*this)
+{
+    ExecutionFlags = (int32)(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Client | EProcessorExecutionFlags::Standalone);
+    ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+
+    // Water queries go through water body components
+    bRequiresGameThreadExecution = true;
+}
+
+void UBuoyancyMassProcessor::ConfigureQueries()
+{
+    EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddRequirement<FBuoyancyMassStateFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddConstSharedRequirement<FBuoyancyMassPointSetFragment>();
+    EntityQuery.AddConstSharedRequirement<FBuoyancyMassParametersFragment>();
+}
+
+void UBuoyancyMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+    const UWorld* World = EntityManager.GetWorld();
+    const UBuoyancyWaterSubsystem* WaterSubsystem = World ? World->GetSubsystem<UBuoyancyWaterSubsystem>() : nullptr;
+
+    if (!WaterSubsystem)
+    {
+        return;
+    }
+
+    // Same clamp as the instanced floating, large frame spikes would make the explicit integration overshoot
+    const float DeltaTime = FMath::Min(Context.GetDeltaTimeSeconds(), 1.0f / 30.0f);
+    const float GravityZ = World->GetGravityZ();
+
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [WaterSubsystem, DeltaTime, GravityZ](FMassExecutionContext& Context)
+    {
+        const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+        const TArrayView<FBuoyancyMassStateFragment> States = Context.GetMutableFragmentView<FBuoyancyMassStateFragment>();
+        const FBuoyancyMassPointSetFragment& PointSet = Context.GetConstSharedFragment<FBuoyancyMassPointSetFragment>();
+        const FBuoyancyMassParametersFragment& Parameters = Context.GetConstSharedFragment<FBuoyancyMassParametersFragment>();
+
+        BuoyancyMath::FPointFrame PointFrame;
+        BuoyancyMath::FPointForceParams ForceParams;
+        ForceParams.VolumePerPoint = PointSet.VolumePerPoint;
+        ForceParams.SubmersionHeight = PointSet.SubmersionHeight;
+        ForceParams.WaterDensity = Parameters.WaterDensity;
+        ForceParams.BuoyancyForceMultiplier = Parameters.BuoyancyForceMultiplier;
+        ForceParams.GravityMagnitude = FMath::Max(-GravityZ, KINDA_SMALL_NUMBER);
+        ForceParams.LinearDrag = Parameters.LinearDamping;
+        ForceParams.QuadraticDrag = Parameters.QuadraticDrag;
+        ForceParams.SlammingCoefficient = Parameters.SlammingCoefficient;
+
+        const float TotalVolume = PointSet.Points.Num() * PointSet.VolumePerPoint;
+
+        // Solid sphere around the points, entities have no physics body to ask for the real inertia
+        const float Inertia = FMath::Max(0.4f * Parameters.Mass * FMath::Square(PointSet.BoundingRadius), KINDA_SMALL_NUMBER);
+
+        for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); EntityIndex++)
+        {
+            FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+            FBuoyancyMassStateFragment& State = States[EntityIndex];
+
+            // Same float frame as the component, centred on the entity and level with the water body under it
+            const int32 WaterBodyIndex = WaterSubsystem->FindWaterBodyIndex(Transform.GetLocation());
+            float SubmergedFraction = 0.0f;
+
+            State.Force = FVector(0.0f, 0.0f, Parameters.Mass * GravityZ);
+            State.Torque = FVector::ZeroVector;
+
+            if (WaterBodyIndex != INDEX_NONE)
+            {
+                const FVector FrameOrigin = WaterSubsystem->GetWaterFrameOrigin(WaterBodyIndex, Transform.GetLocation());
+                const FTransform3f LocalTransform(FQuat4f(Transform.GetRotation()), FVector3f(Transform.GetLocation() - FrameOrigin), FVector3f(Transform.GetScale3D()));
+
+                BuoyancyMath::TransformPoints(LocalTransform, PointSet.Points, PointFrame);
+                WaterSubsystem->GetWaterHeightsInFrame(WaterBodyIndex, FrameOrigin, PointFrame);
+
+                // Same per-point buoyancy, drag and slamming as the component, from the entity's own velocity
+                ForceParams.CenterOfMass = LocalTransform.GetLocation();
+                ForceParams.LinearVelocity = FVector3f(State.LinearVelocity);
+                ForceParams.AngularVelocity = FVector3f(State.AngularVelocity);
+
+                BuoyancyMath::FPointForceResult Result;
+                BuoyancyMath::AccumulatePointForces(PointFrame, ForceParams, Result);
+
+                const float MaxSlammingForce = BuoyancyMath::GetMaxSlammingForce(Result.EnteringSpeedVolume, TotalVolume, Result.Force.Z, Parameters.Mass, GravityZ, DeltaTime);
+                if (Result.SlammingForce.Z > MaxSlammingForce)
+                {
+                    const float SlammingScale = MaxSlammingForce / Result.SlammingForce.Z;
+                    Result.SlammingForce *= SlammingScale;
+                    Result.SlammingTorque *= SlammingScale;
+                }
+
+                State.Force += FVector(Result.Force + Result.SlammingForce);
+                State.Torque += FVector(Result.Torque + Result.SlammingTorque);
+                SubmergedFraction = TotalVolume > 0.0f ? FMath::Min(Result.SubmergedVolume / TotalVolume, 1.0f) : 0.0f;
+            }
+
+            // Rotational drag is integrated implicitly so light entities stay stable
+            State.LinearVelocity += State.Force / Parameters.Mass * DeltaTime;
+            State.AngularVelocity = (State.AngularVelocity + State.Torque / Inertia * DeltaTime) / (1.0f + Parameters.AngularDamping * SubmergedFraction / Inertia * DeltaTime);
+
+            Transform.AddToTranslation(State.LinearVelocity * DeltaTime);
+
+            const float AngularSpeed = State.AngularVelocity.Size();
+            if (AngularSpeed > KINDA_SMALL_NUMBER)
+            {
+                FQuat DeltaRotation(State.AngularVelocity / AngularSpeed, AngularSpeed * DeltaTime);
+                Transform.SetRotation((DeltaRotation * Transform.GetRotation()).GetNormalized());
+            }
+        }
+    });
+}
+
+UBuoyancyMassUpgradeProcessor::UBuoyancyMassUpgradeProcessor()
+    : EntityQuery(*this)
+{
+    // Upgraded actors replicate, clients only follow the server
+    ExecutionFlags = (int32)(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+    ExecutionOrder.ExecuteAfter.Add(UBuoyancyMassProcessor::StaticClass()->GetFName());
+    bRequiresGameThreadExecution = true;
+}
+
+void UBuoyancyMassUpgradeProcessor::ConfigureQueries()
+{
+    EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+    EntityQuery.AddRequirement<FBuoyancyMassStateFragment>(EMassFragmentAccess::ReadOnly);
+    EntityQuery.AddConstSharedRequirement<FBuoyancyMassParametersFragment>();
+}
+
+void UBuoyancyMassUpgradeProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+    UWorld* World = EntityManager.GetWorld();
+    if (!World) return;
+
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+    for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+    {
+        if (APlayerController* PlayerController = Iterator->Get())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            ViewLocations.Add(ViewLocation);
+        }
+    }
+
+    if (ViewLocations.Num() == 0)
+    {
+        return;
+    }
+
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [World, &ViewLocations](FMassExecutionContext& Context)
+    {
+        const FBuoyancyMassParametersFragment& Parameters = Context.GetConstSharedFragment<FBuoyancyMassParametersFragment>();
+
+        if (!Parameters.ActorClass || Parameters.UpgradeDistance <= 0.0f)
+        {
+            return;
+        }
+
+        const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+        const TConstArrayView<FBuoyancyMassStateFragment> States = Context.GetFragmentView<FBuoyancyMassStateFragment>();
+        const float UpgradeDistanceSquared = FMath::Square(Parameters.UpgradeDistance);
+
+        for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); EntityIndex++)
+        {
+            const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+
+            const bool bNearPlayer = ViewLocations.ContainsByPredicate([&Transform, UpgradeDistanceSquared](const FVector& ViewLocation)
+            {
+                return FVector::DistSquared(ViewLocation, Transform.GetLocation()) <= UpgradeDistanceSquared;
+            });
+
+            if (!bNearPlayer)
+            {
+                continue;
+            }
+
+            FActorSpawnParameters SpawnParameters;
+            SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+            AActor* Actor = World->SpawnActor<AActor>(Parameters.ActorClass, Transform, SpawnParameters);
+            if (!Actor)
+            {
+                continue;
+            }
+
+            // Carry the motion over so the swap doesn't pop
+            if (UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent()))
+            {
+                RootPrimitive->SetPhysicsLinearVelocity(States[EntityIndex].LinearVelocity);
+                RootPrimitive->SetPhysicsAngularVelocityInRadians(States[EntityIndex].AngularVelocity);
+            }
+
+            Context.Defer().DestroyEntity(Context.GetEntity(EntityIndex));
+        }
+    });
+}
@@ -0,0 +1,137 @@
+#include "BuoyancyMassTrait.h"
+#include "BuoyancyMassFragments.h"
+#include "MassCommonFragments.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "WaterPhysicsComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+
+namespace BuoyancyMassTrait
+{
+    /** Root component template of an actor class, from the native defaults or the construction script of its Blueprints */
+    static const USceneComponent* GetDefaultRootComponent(TSubclassOf<AActor> ActorClass)
+    {
+        if (!ActorClass)
+        {
+            return nullptr;
+        }
+
+        if (const USceneComponent* Root = ActorClass->GetDefaultObject<AActor>()->GetRootComponent())
+        {
+            return Root;
+        }
+
+        // The root is added by the most basic Blueprint in the hierarchy, children attach to it
+        TArray<const UBlueprintGeneratedClass*, TInlineAllocator<4>> BlueprintClasses;
+        for (const UBlueprintGeneratedClass* BlueprintClass = Cast<UBlueprintGeneratedClass>(ActorClass.Get()); BlueprintClass;
+             BlueprintClass = Cast<UBlueprintGeneratedClass>(BlueprintClass->GetSuperClass()))
+        {
+            BlueprintClasses.Insert(BlueprintClass, 0);
+        }
+
+        for (const UBlueprintGeneratedClass* BlueprintClass : BlueprintClasses)
+        {
+            if (!BlueprintClass->SimpleConstructionScript)
+            {
+                continue;
+            }
+
+            for (const USCS_Node* Node : BlueprintClass->SimpleConstructionScript->GetRootNodes())
+            {
+                const USceneComponent* Root = Node ? Cast<USceneComponent>(Node->ComponentTemplate) : nullptr;
+
+                if (Root && Node->ParentComponentOrVariableName == NAME_None)
+                {
+                    return Root;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+void UBuoyancyMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+    FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+
+    BuildContext.RequireFragment<FTransformFragment>();
+    BuildContext.AddFragment<FBuoyancyMassStateFragment>();
+
+    FBuoyancyMassPointSetFragment PointSet;
+    FBuoyancyMassParametersFragment Parameters;
+    Parameters.Mass = Mass;
+    Parameters.ActorClass = ActorClass;
+    Parameters.UpgradeDistance = UpgradeDistance;
+
+    int32 PointsPerAxis = 3;
+
+    TArray<const UActorComponent*> Components;
+    AActor::GetActorClassDefaultComponents(ActorClass, Components);
+
+    for (const UActorComponent* Component : Components)
+    {
+        if (const UWaterPhysicsComponent* WaterPhysics = Cast<UWaterPhysicsComponent>(Component))
+        {
+            Parameters.WaterDensity = WaterPhysics->WaterDensity;
+            Parameters.BuoyancyForceMultiplier = WaterPhysics->BuoyancyForceMultiplier;
+            Parameters.LinearDamping = WaterPhysics->LinearDamping;
+            Parameters.AngularDamping = WaterPhysics->AngularDamping;
+            Parameters.QuadraticDrag = WaterPhysics->QuadraticDrag;
+            Parameters.SlammingCoefficient = WaterPhysics->SlammingCoefficient;
+            PointsPerAxis = WaterPhysics->PointsPerAxis;
+        }
+    }
+
+    // Entities are a single rigid body and their transform is the actor's, which is the root's. Float them
+    // on the root collision, whose relative location and rotation are replaced by the actor's own
+    const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(BuoyancyMassTrait::GetDefaultRootComponent(ActorClass));
+
+    if (RootPrimitive && UWaterPhysicsComponent::IsBuoyancyPrimitive(RootPrimitive)
+        && UWaterPhysicsComponent::BuildPrimitivePointSet(RootPrimitive, PointsPerAxis, PointSet.Points, PointSet.VolumePerPoint, PointSet.SubmersionHeight))
+    {
+        const FVector3f Scale = FVector3f(RootPrimitive->GetRelativeScale3D());
+
+        for (FVector3f& Point : PointSet.Points)
+        {
+            Point *= Scale;
+        }
+    }
+    else
+    {
+        // Otherwise use the first collision the actor would float on, placed by its relative transform to the root
+        for (const UActorComponent* Component : Components)
+        {
+            const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+
+            if (Primitive && UWaterPhysicsComponent::IsBuoyancyPrimitive(Primitive)
+                && UWaterPhysicsComponent::BuildPrimitivePointSet(Primitive, PointsPerAxis, PointSet.Points, PointSet.VolumePerPoint, PointSet.SubmersionHeight))
+            {
+                const FTransform3f RelativeTransform = FTransform3f(Primitive->GetRelativeTransform());
+
+                for (FVector3f& Point : PointSet.Points)
+                {
+                    Point = RelativeTransform.TransformPosition(Point);
+                }
+
+                break;
+            }
+        }
+    }
+
+    for (const FVector3f& Point : PointSet.Points)
+    {
+        PointSet.BoundingRadius = FMath::Max(PointSet.BoundingRadius, Point.Size());
+    }
+
+    if (PointSet.Points.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Buoyancy trait: %s has no BoxComponent, SphereComponent, CapsuleComponent or StaticMeshComponent to float on"),
+               *GetNameSafe(ActorClass));
+    }
+
+    BuildContext.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(PointSet));
+    BuildContext.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(Parameters));
+}
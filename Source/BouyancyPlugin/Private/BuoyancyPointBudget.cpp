@@ -0,0 +1,344 @@
+#include "BuoyancyPointBudget.h"
+#include "BuoyancyMath.h"
+#include "WaterPhysicsComponent.h"
+#include "HydrostaticTable.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+
+namespace BuoyancyPointBudget
+{
+    /** Resolution of the voxel reference the point sets are compared against */
+    constexpr int32 ReferenceVoxelResolution = 32;
+    constexpr int32 MaxSettleIterations = 300;
+    constexpr int32 WaterHeightIterations = 24;
+
+    /** Pose the shapes are dropped in, slightly off level so unstable upright poses tip over the same way for both models */
+    const FRotator DropRotation(3.0f, 0.0f, 2.0f);
+
+    struct FPointModel
+    {
+        const TArray<FVector3f>* Points = nullptr;
+        float VolumePerPoint = 0.0f;
+        float SubmersionHeight = 1.0f;
+    };
+
+    /** Submerged volume with the same per-point ramp as the runtime, and its first moment about the body origin */
+    static float GetSubmergedVolume(const FPointModel& Model, const FQuat& Orientation, float WaterHeight, FVector& OutMoment)
+    {
+        float Volume = 0.0f;
+        OutMoment = FVector::ZeroVector;
+
+        for (const FVector3f& LocalPoint : *Model.Points)
+        {
+            FVector Point = Orientation.RotateVector(FVector(LocalPoint));
+
+            if (Point.Z < WaterHeight)
+            {
+                float SubmergedVolume = BuoyancyMath::GetSubmergedVolume(WaterHeight - Point.Z, Model.VolumePerPoint, Model.SubmersionHeight);
+
+                Volume += SubmergedVolume;
+                OutMoment += Point * SubmergedVolume;
+            }
+        }
+
+        return Volume;
+    }
+
+    /** Water height above the body origin at which the body displaces TargetVolume */
+    static float SolveWaterHeight(const FPointModel& Model, const FQuat& Orientation, float TargetVolume, float Radius)
+    {
+        float Low = -Radius;
+        float High = Radius;
+        FVector Moment;
+
+        for (int32 i = 0; i < WaterHeightIterations; i++)
+        {
+            float Mid = 0.5f * (Low + High);
+
+            if (GetSubmergedVolume(Model, Orientation, Mid, Moment) < TargetVolume)
+            {
+                Low = Mid;
+            }
+            else
+            {
+                High = Mid;
+            }
+        }
+
+        return 0.5f * (Low + High);
+    }
+
+    /** Settles the body about its origin: solve the draft for the current tilt, then turn along the righting torque until it vanishes */
+    static FQuat Settle(const FPointModel& Model, float TargetVolume, float Radius, float& OutWaterHeight)
+    {
+        FQuat Orientation = DropRotation.Quaternion();
+        OutWaterHeight = 0.0f;
+
+        for (int32 Iteration = 0; Iteration < MaxSettleIterations; Iteration++)
+        {
+            OutWaterHeight = SolveWaterHeight(Model, Orientation, TargetVolume, Radius);
+
+            FVector Moment;
+            float Volume = GetSubmergedVolume(Model, Orientation, OutWaterHeight, Moment);
+
+            if (Volume <= KINDA_SMALL_NUMBER)
+            {
+                break;
+            }
+
+            // Buoyancy pushes up through the centre of buoyancy, so the righting arm is its offset crossed with up
+            FVector RightingArm = FVector::CrossProduct(Moment / Volume, FVector::UpVector);
+            float Step = FMath::Min(0.5f * RightingArm.Size() / Radius, 0.05f);
+
+            if (Step < 1e-4f)
+            {
+                break;
+            }
+
+            Orientation = FQuat(RightingArm.GetSafeNormal(), Step) * Orientation;
+        }
+
+        return Orientation;
+    }
+
+    static const USceneComponent* GetAttachParent(const USceneComponent* Component, const FBuoyancyPointBudgetTuner::FAttachParentMap& AttachParents)
+    {
+        const USceneComponent* const* Parent = AttachParents.Find(Component);
+        return Parent ? *Parent : Component->GetAttachParent();
+    }
+
+    /** Templates are not welded yet, a child welds to the first simulating primitive above it as long as every step auto welds */
+    static bool IsFloated(const UPrimitiveComponent* Primitive, const FBuoyancyPointBudgetTuner::FAttachParentMap& AttachParents)
+    {
+        if (Primitive->BodyInstance.bSimulatePhysics || Primitive->BodyInstance.WeldParent)
+        {
+            return true;
+        }
+
+        for (const UPrimitiveComponent* Child = Primitive; Child->BodyInstance.bAutoWeld; )
+        {
+            const UPrimitiveComponent* Parent = Cast<UPrimitiveComponent>(GetAttachParent(Child, AttachParents));
+
+            if (!Parent)
+            {
+                return false;
+            }
+
+            if (Parent->BodyInstance.bSimulatePhysics)
+            {
+                return true;
+            }
+
+            Child = Parent;
+        }
+
+        return false;
+    }
+}
+
+void FBuoyancyPointBudgetTuner::GetFloatedPrimitives(const TArray<UPrimitiveComponent*>& Primitives, const FAttachParentMap& AttachParents, TArray<UPrimitiveComponent*>& OutFloated)
+{
+    for (UPrimitiveComponent* Primitive : Primitives)
+    {
+        if (Primitive && UWaterPhysicsComponent::IsBuoyancyPrimitive(Primitive) && BuoyancyPointBudget::IsFloated(Primitive, AttachParents))
+        {
+            OutFloated.Add(Primitive);
+        }
+    }
+
+    if (OutFloated.Num() > 0)
+    {
+        return;
+    }
+
+    // Nothing simulates, the component falls back to the first collision in this order
+    for (const UClass* FallbackClass : { UBoxComponent::StaticClass(), USphereComponent::StaticClass(), UCapsuleComponent::StaticClass(), UStaticMeshComponent::StaticClass() })
+    {
+        for (UPrimitiveComponent* Primitive : Primitives)
+        {
+            if (Primitive && Primitive->IsA(FallbackClass) && UWaterPhysicsComponent::IsBuoyancyPrimitive(Primitive))
+            {
+                OutFloated.Add(Primitive);
+                return;
+            }
+        }
+    }
+}
+
+FBuoyancyPointBudgetTuner::FBuoyancyPointBudgetTuner(const UWaterPhysicsComponent* WaterPhysics)
+{
+    if (WaterPhysics)
+    {
+        DraftTolerance = FMath::Max(WaterPhysics->PointBudgetDraftTolerance, KINDA_SMALL_NUMBER);
+        TiltTolerance = FMath::Max(WaterPhysics->PointBudgetTiltTolerance, KINDA_SMALL_NUMBER);
+        CurrentPointsPerAxis = FMath::Max(2, WaterPhysics->PointsPerAxis);
+        MaxPointsPerAxis = FMath::Max(2, WaterPhysics->MaxPointsPerAxis);
+        WaterDensity = WaterPhysics->WaterDensity;
+        BuoyancyForceMultiplier = WaterPhysics->BuoyancyForceMultiplier;
+    }
+}
+
+float FBuoyancyPointBudgetTuner::GetSubmergedFraction(UPrimitiveComponent* Primitive, float ShapeVolume) const
+{
+    // Same balance as the runtime: buoyancy per unit of volume against the weight of the body
+    const FVector Scale = Primitive->GetComponentScale();
+    const float ScaledVolume = ShapeVolume * FMath::Abs(Scale.X * Scale.Y * Scale.Z);
+    const float BuoyancyPerVolume = BuoyancyMath::GetBuoyancyForce(1.0f, WaterDensity, BuoyancyForceMultiplier);
+    const float Mass = Primitive->CalculateMass();
+
+    if (Mass <= 0.0f || ScaledVolume <= 0.0f || BuoyancyPerVolume <= 0.0f)
+    {
+        return 0.5f;
+    }
+
+    // Bodies that sink or barely touch the water have no meaningful draft, tune them half submerged instead
+    const float Weight = Mass * -UPhysicsSettings::Get()->DefaultGravityZ;
+    return FMath::Clamp(Weight / (BuoyancyPerVolume * ScaledVolume), 0.05f, 0.95f);
+}
+
+FBuoyancyPointBudgetResult FBuoyancyPointBudgetTuner::Tune(const TArray<UPrimitiveComponent*>& Primitives, const FAttachParentMap& AttachParents) const
+{
+    using namespace BuoyancyPointBudget;
+
+    FBuoyancyPointBudgetResult Result;
+
+    // Triggers and visual meshes that never simulate would skew the errors and the point counts
+    TArray<UPrimitiveComponent*> FloatedPrimitives;
+    GetFloatedPrimitives(Primitives, AttachParents, FloatedPrimitives);
+
+    for (int32 PointsPerAxis = 2; PointsPerAxis <= FMath::Max(MaxPointsPerAxis, CurrentPointsPerAxis); PointsPerAxis++)
+    {
+        Result.Samples.AddDefaulted_GetRef().PointsPerAxis = PointsPerAxis;
+    }
+
+    for (UPrimitiveComponent* Primitive : FloatedPrimitives)
+    {
+        FKAggregateGeom AggGeom;
+        if (!UWaterPhysicsComponent::GetHydrostaticShape(Primitive, AggGeom))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Cannot tune %s: mesh has no collision setup"), *Primitive->GetName());
+            continue;
+        }
+
+        TArray<FVector> Cells;
+        const FVector CellSize = UHydrostaticTable::Voxelize(AggGeom, ReferenceVoxelResolution, Cells);
+
+        if (Cells.Num() == 0)
+        {
+            continue;
+        }
+
+        const FBox Bounds = AggGeom.CalcAABB(FTransform::Identity);
+        const float ShapeSize = FMath::Max(Bounds.GetSize().GetMax(), 1.0f);
+        const float Radius = Bounds.GetExtent().Size() + Bounds.GetCenter().Size();
+
+        TArray<FVector3f> ReferencePoints;
+        ReferencePoints.Reserve(Cells.Num());
+        for (const FVector& Cell : Cells)
+        {
+            ReferencePoints.Add(FVector3f(Cell));
+        }
+
+        FPointModel Reference;
+        Reference.Points = &ReferencePoints;
+        Reference.VolumePerPoint = CellSize.X * CellSize.Y * CellSize.Z;
+        Reference.SubmersionHeight = FMath::Max(CellSize.Z, KINDA_SMALL_NUMBER);
+
+        const float ShapeVolume = Cells.Num() * Reference.VolumePerPoint;
+        const float SubmergedFraction = GetSubmergedFraction(Primitive, ShapeVolume);
+        const float TargetVolume = SubmergedFraction * ShapeVolume;
+
+        float ReferenceWaterHeight = 0.0f;
+        const FQuat ReferenceOrientation = Settle(Reference, TargetVolume, Radius, ReferenceWaterHeight);
+        const FVector ReferenceUp = ReferenceOrientation.UnrotateVector(FVector::UpVector);
+
+        UE_LOG(LogTemp, Warning, TEXT(" Tuning %s: %.0f%% submerged, reference draft %.1f"),
+               *Primitive->GetName(), SubmergedFraction * 100.0f, ReferenceWaterHeight);
+
+        for (FBuoyancyPointBudgetSample& Sample : Result.Samples)
+        {
+            TArray<FVector3f> Points;
+            FPointModel Model;
+            Model.Points = &Points;
+
+            if (!UWaterPhysicsComponent::BuildPrimitivePointSet(Primitive, Sample.PointsPerAxis, Points, Model.VolumePerPoint, Model.SubmersionHeight) || Points.Num() == 0)
+            {
+                continue;
+            }
+
+            Model.SubmersionHeight = FMath::Max(Model.SubmersionHeight, KINDA_SMALL_NUMBER);
+
+            float WaterHeight = 0.0f;
+            const FQuat Orientation = Settle(Model, TargetVolume, Radius, WaterHeight);
+            const float UpDot = FVector::DotProduct(Orientation.UnrotateVector(FVector::UpVector), ReferenceUp);
+
+            Sample.NumPoints += Points.Num();
+            Sample.DraftError = FMath::Max(Sample.DraftError, FMath::Abs(WaterHeight - ReferenceWaterHeight) / ShapeSize);
+            Sample.TiltError = FMath::Max(Sample.TiltError, FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(UpDot, -1.0f, 1.0f))));
+        }
+
+        // Construction script templates carry a suffix the Blueprint editor does not show
+        FString PrimitiveName = Primitive->GetName();
+        PrimitiveName.RemoveFromEnd(UActorComponent::ComponentTemplateNameSuffix);
+        Result.TunedPrimitives.Add(PrimitiveName);
+        Result.NumPrimitives++;
+    }
+
+    if (Result.NumPrimitives == 0)
+    {
+        Result.Samples.Empty();
+        return Result;
+    }
+
+    // Cheapest setting within tolerance with ties going to the more accurate one, otherwise the most accurate setting
+    int32 BestIndex = INDEX_NONE;
+    float BestError = 0.0f;
+
+    for (int32 i = 0; i < Result.Samples.Num(); i++)
+    {
+        FBuoyancyPointBudgetSample& Sample = Result.Samples[i];
+        Sample.bWithinTolerance = Sample.DraftError <= DraftTolerance && Sample.TiltError <= TiltTolerance;
+
+        if (Sample.PointsPerAxis == CurrentPointsPerAxis)
+        {
+            Result.Current = Sample;
+        }
+
+        if (Sample.PointsPerAxis > MaxPointsPerAxis)
+        {
+            continue;
+        }
+
+        const float Error = Sample.DraftError / DraftTolerance + Sample.TiltError / TiltTolerance;
+        bool bIsBetter = BestIndex == INDEX_NONE;
+
+        if (!bIsBetter)
+        {
+            const FBuoyancyPointBudgetSample& Best = Result.Samples[BestIndex];
+
+            if (Sample.bWithinTolerance != Best.bWithinTolerance)
+            {
+                bIsBetter = Sample.bWithinTolerance;
+            }
+            else if (Sample.bWithinTolerance && Sample.NumPoints != Best.NumPoints)
+            {
+                bIsBetter = Sample.NumPoints < Best.NumPoints;
+            }
+            else
+            {
+                bIsBetter = Error < BestError;
+            }
+        }
+
+        if (bIsBetter)
+        {
+            BestIndex = i;
+            BestError = Error;
+        }
+    }
+
+    Result.Best = Result.Samples[BestIndex];
+    return Result;
+}
@@ -0,0 +1,169 @@
+#include "BuoyancyWaterSubsystem.h"
+#include "EngineUtils.h"
+#include "WaterBodyComponent.h"
+
+void UBuoyancyWaterSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    RefreshWaterBodies();
+    ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UBuoyancyWaterSubsystem::OnActorSpawned));
+}
+
+void UBuoyancyWaterSubsystem::Deinitialize()
+{
+    if (GetWorld())
+    {
+        GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+    }
+
+    WaterBodies.Empty();
+    WaterBodyBounds.Empty();
+
+    Super::Deinitialize();
+}
+
+void UBuoyancyWaterSubsystem::RefreshWaterBodies()
+{
+    WaterBodies.Empty();
+    WaterBodyBounds.Empty();
+
+    for (TActorIterator<AWaterBody> WaterBodyIterator(GetWorld()); WaterBodyIterator; ++WaterBodyIterator)
+    {
+        AddWaterBody(*WaterBodyIterator);
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT(" Cached %d water bodies for buoyancy"), WaterBodies.Num());
+}
+
+void UBuoyancyWaterSubsystem::AddWaterBody(AWaterBody* WaterBody)
+{
+    if (!WaterBody || !WaterBody->GetWaterBodyComponent())
+    {
+        return;
+    }
+
+    WaterBodies.Add(WaterBody);
+    WaterBodyBounds.Add(WaterBody->GetComponentsBoundingBox(true));
+}
+
+void UBuoyancyWaterSubsystem::OnActorSpawned(AActor* SpawnedActor)
+{
+    if (AWaterBody* WaterBody = Cast<AWaterBody>(SpawnedActor))
+    {
+        AddWaterBody(WaterBody);
+    }
+}
+
+int32 UBuoyancyWaterSubsystem::FindWaterBodyIndex(const FVector& WorldLocation) const
+{
+    // Prefer the water body whose bounds contain the location, fall back to the first one
+    int32 WaterBodyIndex = INDEX_NONE;
+
+    for (int32 i = 0; i < WaterBodies.Num(); i++)
+    {
+        if (!IsValid(WaterBodies[i]))
+        {
+            continue;
+        }
+
+        if (WaterBodyIndex == INDEX_NONE)
+        {
+            WaterBodyIndex = i;
+        }
+
+        if (WaterBodyBounds[i].IsInsideXY(WorldLocation))
+        {
+            WaterBodyIndex = i;
+            break;
+        }
+    }
+
+    return WaterBodyIndex;
+}
+
+float UBuoyancyWaterSubsystem::GetWaterHeightAtLocation(const FVector& WorldLocation) const
+{
+    const int32 WaterBodyIndex = FindWaterBodyIndex(WorldLocation);
+
+    if (WaterBodyIndex == INDEX_NONE) return -99999.0f;
+
+    return GetWaterHeightAtLocation(WaterBodyIndex, WorldLocation);
+}
+
+float UBuoyancyWaterSubsystem::GetWaterHeightAtLocation(int32 WaterBodyIndex, const FVector& WorldLocation) const
+{
+    return (float)GetWaterSurfaceHeight(WaterBodies[WaterBodyIndex], WorldLocation, GetWorld()->GetTimeSeconds());
+}
+
+bool UBuoyancyWaterSubsystem::IsInsideWaterBody(int32 WaterBodyIndex, const FVector& WorldLocation) const
+{
+    return WaterBodies.IsValidIndex(WaterBodyIndex) && IsValid(WaterBodies[WaterBodyIndex]) && WaterBodyBounds[WaterBodyIndex].IsInsideXY(WorldLocation);
+}
+
+void UBuoyancyWaterSubsystem::GetWaterHeightsInFrame(int32 WaterBodyIndex, const FVector& FrameOrigin, BuoyancyMath::FPointFrame& Frame) const
+{
+    AWaterBody* WaterBody = WaterBodies[WaterBodyIndex];
+    const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+    // The water plugin only answers in world space, the shared helper brings its heights back into the frame
+    BuoyancyMath::SampleWaterHeightsInFrame(FrameOrigin, Frame, [this, WaterBody, CurrentTime](const FVector& WorldLocation)
+    {
+        return GetWaterSurfaceHeight(WaterBody, WorldLocation, CurrentTime);
+    });
+}
+
+double UBuoyancyWaterSubsystem::GetWaterSurfaceHeight(AWaterBody* WaterBody, const FVector& WorldLocation, float Time) const
+{
+    FVector WaterSurfaceLocation;
+    FVector WaterSurfaceNormal;
+    FVector WaterVelocity;
+    float WaterDepth;
+
+    WaterBody->GetWaterBodyComponent()->GetWaterSurfaceInfoAtLocation(
+        WorldLocation,
+        WaterSurfaceLocation,
+        WaterSurfaceNormal,
+        WaterVelocity,
+        WaterDepth,
+        true
+    );
+
+    double WaterHeight = WaterSurfaceLocation.Z;
+
+    if (UWaterWavesBase* WaterWaves = WaterBody->GetWaterWaves())
+    {
+        float WaveDisplacement = WaterWaves->GetSimpleWaveHeightAtPosition(
+            WorldLocation,
+            WaterDepth,
+            Time
+        );
+
+        WaterHeight += WaveDisplacement;
+    }
+
+    return WaterHeight;
+}
+
+FVector UBuoyancyWaterSubsystem::GetWaterFrameOrigin(int32 WaterBodyIndex, const FVector& WorldLocation) const
+{
+    return BuoyancyMath::GetWaterFrameOrigin(WorldLocation, WaterBodies[WaterBodyIndex]->GetActorLocation().Z);
+}
+
+bool UBuoyancyWaterSubsystem::IsNearWater(const FBox& Bounds) const
+{
+    for (int32 i = 0; i < WaterBodies.Num(); i++)
+    {
+        if (IsValid(WaterBodies[i]) && WaterBodyBounds[i].Intersect(Bounds))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UBuoyancyWaterSubsystem::SetBuoyancyActive(bool bActive)
+{
+    NumActiveBuoyancyComponents = FMath::Max(0, NumActiveBuoyancyComponents + (bActive ? 1 : -1));
+}
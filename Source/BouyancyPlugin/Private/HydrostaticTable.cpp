@@ -0,0 +1,215 @@
+#include "HydrostaticTable.h"
+
+static bool IsInsideAggregateGeom(const FKAggregateGeom& AggGeom, const FVector& LocalPoint)
+{
+    for (const FKBoxElem& BoxElem : AggGeom.BoxElems)
+    {
+        if (BoxElem.GetShortestDistanceToPoint(LocalPoint, FTransform::Identity) <= 0.0f)
+        {
+            return true;
+        }
+    }
+
+    for (const FKSphereElem& SphereElem : AggGeom.SphereElems)
+    {
+        if (SphereElem.GetShortestDistanceToPoint(LocalPoint, FTransform::Identity) <= 0.0f)
+        {
+            return true;
+        }
+    }
+
+    for (const FKSphylElem& CapsuleElem : AggGeom.SphylElems)
+    {
+        if (CapsuleElem.GetShortestDistanceToPoint(LocalPoint, FTransform::Identity) <= 0.0f)
+        {
+            return true;
+        }
+    }
+
+    for (const FKConvexElem& ConvexElem : AggGeom.ConvexElems)
+    {
+        if (ConvexElem.GetShortestDistanceToPoint(LocalPoint, FTransform::Identity) <= 0.0f)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+FVector UHydrostaticTable::Voxelize(const FKAggregateGeom& AggGeom, int32 VoxelResolution, TArray<FVector>& OutCells)
+{
+    OutCells.Reset();
+
+    const FBox Bounds = AggGeom.CalcAABB(FTransform::Identity);
+    if (!Bounds.IsValid)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot voxelize shape: it has no collision geometry"));
+        return FVector::ZeroVector;
+    }
+
+    const FVector CellSize = Bounds.GetSize() / VoxelResolution;
+
+    for (int32 X = 0; X < VoxelResolution; X++)
+    {
+        for (int32 Y = 0; Y < VoxelResolution; Y++)
+        {
+            for (int32 Z = 0; Z < VoxelResolution; Z++)
+            {
+                FVector CellCenter = Bounds.Min + CellSize * (FVector(X, Y, Z) + 0.5f);
+
+                if (IsInsideAggregateGeom(AggGeom, CellCenter))
+                {
+                    OutCells.Add(CellCenter);
+                }
+            }
+        }
+    }
+
+    return CellSize;
+}
+
+void UHydrostaticTable::Bake(const FKAggregateGeom& AggGeom, int32 InDraftSteps, int32 InPitchSteps, int32 InRollSteps, int32 VoxelResolution)
+{
+    DraftSteps = FMath::Max(2, InDraftSteps);
+    PitchSteps = FMath::Max(2, InPitchSteps);
+    RollSteps = FMath::Max(4, InRollSteps);
+    VoxelResolution = FMath::Max(4, VoxelResolution);
+
+    Volumes.Empty();
+    Centres.Empty();
+    TotalVolume = 0.0f;
+
+    // Voxelize the shape once, every (pitch, roll) entry reuses the same interior cells
+    TArray<FVector> Cells;
+    const FVector CellSize = Voxelize(AggGeom, VoxelResolution, Cells);
+    const float CellVolume = CellSize.X * CellSize.Y * CellSize.Z;
+
+    if (Cells.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Hydrostatic bake failed: no interior cells at resolution %d"), VoxelResolution);
+        return;
+    }
+
+    float MaxRadius = 0.0f;
+    for (const FVector& Cell : Cells)
+    {
+        MaxRadius = FMath::Max(MaxRadius, (float)Cell.Size());
+    }
+
+    MaxDraft = MaxRadius + CellSize.GetMax();
+    MinDraft = -MaxDraft;
+    TotalVolume = Cells.Num() * CellVolume;
+
+    const int32 NumEntries = DraftSteps * PitchSteps * RollSteps;
+    Volumes.SetNumZeroed(NumEntries);
+    Centres.SetNumZeroed(NumEntries);
+
+    TArray<float> Heights;
+    TArray<int32> Order;
+    Heights.SetNumUninitialized(Cells.Num());
+    Order.SetNumUninitialized(Cells.Num());
+
+    for (int32 Roll = 0; Roll < RollSteps; Roll++)
+    {
+        for (int32 Pitch = 0; Pitch < PitchSteps; Pitch++)
+        {
+            float PitchAngle = -90.0f + 180.0f * Pitch / (PitchSteps - 1);
+            float RollAngle = -180.0f + 360.0f * Roll / RollSteps;
+            FVector LocalUp = FRotator(PitchAngle, 0.0f, RollAngle).Quaternion().UnrotateVector(FVector::UpVector);
+
+            for (int32 i = 0; i < Cells.Num(); i++)
+            {
+                Heights[i] = FVector::DotProduct(LocalUp, Cells[i]);
+                Order[i] = i;
+            }
+
+            Order.Sort([&Heights](int32 A, int32 B) { return Heights[A] < Heights[B]; });
+
+            // Sweep the water plane upwards, each draft only adds the cells it newly covers
+            int32 Submerged = 0;
+            FVector Moment = FVector::ZeroVector;
+
+            for (int32 Draft = 0; Draft < DraftSteps; Draft++)
+            {
+                float DraftHeight = MinDraft + (MaxDraft - MinDraft) * Draft / (DraftSteps - 1);
+
+                while (Submerged < Order.Num() && Heights[Order[Submerged]] < DraftHeight)
+                {
+                    Moment += Cells[Order[Submerged]];
+                    Submerged++;
+                }
+
+                const int32 Index = GetIndex(Draft, Pitch, Roll);
+                Volumes[Index] = Submerged * CellVolume;
+                Centres[Index] = Submerged > 0 ? FVector3f(Moment / Submerged) : FVector3f::ZeroVector;
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT(" Baked hydrostatic table: %d x %d x %d entries, %d cells, volume %.1f"),
+           DraftSteps, PitchSteps, RollSteps, Cells.Num(), TotalVolume);
+}
+
+bool UHydrostaticTable::Lookup(float Draft, float Pitch, float Roll, float& OutVolume, FVector& OutCentre) const
+{
+    OutVolume = 0.0f;
+    OutCentre = FVector::ZeroVector;
+
+    if (!IsBaked())
+    {
+        return false;
+    }
+
+    if (Draft <= MinDraft)
+    {
+        return true;
+    }
+
+    float DraftAlpha = FMath::Clamp((Draft - MinDraft) / (MaxDraft - MinDraft), 0.0f, 1.0f) * (DraftSteps - 1);
+    float PitchAlpha = (FMath::Clamp(Pitch, -90.0f, 90.0f) + 90.0f) / 180.0f * (PitchSteps - 1);
+    float RollAlpha = (FRotator::NormalizeAxis(Roll) + 180.0f) / 360.0f * RollSteps;
+
+    int32 Draft0 = FMath::Min(FMath::FloorToInt(DraftAlpha), DraftSteps - 2);
+    int32 Pitch0 = FMath::Min(FMath::FloorToInt(PitchAlpha), PitchSteps - 2);
+    int32 Roll0 = FMath::FloorToInt(RollAlpha);
+
+    float DraftT = DraftAlpha - Draft0;
+    float PitchT = PitchAlpha - Pitch0;
+    float RollT = RollAlpha - Roll0;
+
+    // Roll wraps around, draft and pitch are clamped to the baked range
+    Roll0 = Roll0 % RollSteps;
+    int32 Roll1 = (Roll0 + 1) % RollSteps;
+
+    float Volume = 0.0f;
+    FVector Moment = FVector::ZeroVector;
+
+    for (int32 Corner = 0; Corner < 8; Corner++)
+    {
+        int32 DraftIndex = Draft0 + (Corner & 1);
+        int32 PitchIndex = Pitch0 + ((Corner >> 1) & 1);
+        int32 RollIndex = (Corner & 4) ? Roll1 : Roll0;
+
+        float Weight = ((Corner & 1) ? DraftT : 1.0f - DraftT)
+                     * ((Corner & 2) ? PitchT : 1.0f - PitchT)
+                     * ((Corner & 4) ? RollT : 1.0f - RollT);
+
+        const int32 Index = GetIndex(DraftIndex, PitchIndex, RollIndex);
+        float EntryVolume = Volumes[Index] * Weight;
+
+        // Interpolate the first moment so empty entries don't drag the centre towards the origin
+        Volume += EntryVolume;
+        Moment += FVector(Centres[Index]) * EntryVolume;
+    }
+
+    OutVolume = Volume;
+    OutCentre = Volume > KINDA_SMALL_NUMBER ? Moment / Volume : FVector::ZeroVector;
+    return true;
+}
+
+bool UHydrostaticTable::IsBaked() const
+{
+    const int32 NumEntries = DraftSteps * PitchSteps * RollSteps;
+    return NumEntries > 0 && Volumes.Num() == NumEntries && Centres.Num() == NumEntries && MaxDraft > MinDraft;
+}
@@ -0,0 +1,198 @@
+#include "BuoyancyMath.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BuoyancyFloatFrameTest
+{
+    constexpr int32 PointsPerAxis = 8;
+    constexpr int32 TimingIterations = 2000;
+
+    /** Body pose relative to the water body, the same wherever the water is */
+    const FVector BodyOffset(12.5, -7.25, -20.0);
+    const FQuat BodyRotation = FRotator(4.0f, 30.0f, -3.0f).Quaternion();
+
+    /** Waves measured from the water body, so every water origin sees the same surface */
+    static double GetWaterHeight(const FVector& WorldLocation, const FVector& WaterOrigin)
+    {
+        return WaterOrigin.Z + 5.0 * FMath::Sin((WorldLocation.X - WaterOrigin.X) / 20.0) + 3.0 * FMath::Cos((WorldLocation.Y - WaterOrigin.Y) / 30.0);
+    }
+
+    /** Grid of points filling a 100 cm cube around its centre */
+    static void MakeBoxPoints(TArray<FVector3f>& OutPoints, float& OutVolumePerPoint)
+    {
+        const float PointSize = 100.0f / PointsPerAxis;
+
+        for (int32 X = 0; X < PointsPerAxis; X++)
+        {
+            for (int32 Y = 0; Y < PointsPerAxis; Y++)
+            {
+                for (int32 Z = 0; Z < PointsPerAxis; Z++)
+                {
+                    OutPoints.Add((FVector3f((float)X, (float)Y, (float)Z) + 0.5f) * PointSize - 50.0f);
+                }
+            }
+        }
+
+        OutVolumePerPoint = PointSize * PointSize * PointSize;
+    }
+
+    static BuoyancyMath::FPointForceParams MakeParams(float VolumePerPoint)
+    {
+        BuoyancyMath::FPointForceParams Params;
+        Params.LinearVelocity = FVector3f(150.0f, 40.0f, -80.0f);
+        Params.AngularVelocity = FVector3f(0.3f, -0.2f, 0.5f);
+        Params.VolumePerPoint = VolumePerPoint;
+        Params.SubmersionHeight = 100.0f / PointsPerAxis;
+        Params.LinearDrag = 2.0f;
+        Params.QuadraticDrag = 0.001f;
+        Params.SlammingCoefficient = 1.0f;
+        return Params;
+    }
+
+    /** The frame helpers the water subsystem uses, with the test waves standing in for the water plugin */
+    static BuoyancyMath::FPointForceResult FloatInFrame(const TArray<FVector3f>& Points, float VolumePerPoint, const FVector& WaterOrigin, BuoyancyMath::FPointFrame& Frame)
+    {
+        const FVector BodyLocation = WaterOrigin + BodyOffset;
+        const FVector FrameOrigin = BuoyancyMath::GetWaterFrameOrigin(BodyLocation, WaterOrigin.Z);
+        const FTransform3f LocalTransform(FQuat4f(BodyRotation), FVector3f(BodyLocation - FrameOrigin));
+
+        BuoyancyMath::TransformPoints(LocalTransform, Points, Frame);
+        BuoyancyMath::SampleWaterHeightsInFrame(FrameOrigin, Frame, [&WaterOrigin](const FVector& WorldLocation)
+        {
+            return GetWaterHeight(WorldLocation, WaterOrigin);
+        });
+
+        BuoyancyMath::FPointForceParams Params = MakeParams(VolumePerPoint);
+        Params.CenterOfMass = LocalTransform.GetLocation();
+
+        BuoyancyMath::FPointForceResult Result;
+        BuoyancyMath::AccumulatePointForces(Frame, Params, Result);
+        return Result;
+    }
+
+    /** Same forces with every point in world doubles, the way the runtime worked before the float frame */
+    static FVector FloatInWorldDoubles(const TArray<FVector>& Points, float VolumePerPoint, const FVector& WaterOrigin, FVector& OutTorque)
+    {
+        const BuoyancyMath::FPointForceParams Params = MakeParams(VolumePerPoint);
+        const FVector LinearVelocity = FVector(Params.LinearVelocity);
+        const FVector AngularVelocity = FVector(Params.AngularVelocity);
+        const FTransform BodyTransform(BodyRotation, WaterOrigin + BodyOffset);
+        const FVector CenterOfMass = BodyTransform.GetLocation();
+        const double FullWaterMass = BuoyancyMath::GetBuoyancyForce(VolumePerPoint, Params.WaterDensity, Params.BuoyancyForceMultiplier) / Params.GravityMagnitude;
+
+        FVector Force = FVector::ZeroVector;
+        OutTorque = FVector::ZeroVector;
+
+        for (const FVector& Point : Points)
+        {
+            const FVector WorldPoint = BodyTransform.TransformPosition(Point);
+            const double Depth = GetWaterHeight(WorldPoint, WaterOrigin) - WorldPoint.Z;
+
+            if (Depth <= 0.0)
+            {
+                continue;
+            }
+
+            const double SubmergedVolume = VolumePerPoint * FMath::Clamp(Depth / Params.SubmersionHeight, 0.0, 1.0);
+            const double BuoyancyForce = (SubmergedVolume / 1000.0) * 9.8 * Params.BuoyancyForceMultiplier * Params.WaterDensity;
+
+            const FVector Arm = WorldPoint - CenterOfMass;
+            const FVector PointVelocity = LinearVelocity + FVector::CrossProduct(AngularVelocity, Arm);
+            FVector PointForce = FVector(0.0, 0.0, BuoyancyForce)
+                - PointVelocity * (BuoyancyForce / Params.GravityMagnitude) * (Params.LinearDrag + Params.QuadraticDrag * PointVelocity.Size());
+
+            if (Depth < Params.SubmersionHeight && PointVelocity.Z < 0.0)
+            {
+                PointForce.Z += Params.SlammingCoefficient * FullWaterMass * FMath::Square(PointVelocity.Z) / Params.SubmersionHeight;
+            }
+
+            Force += PointForce;
+            OutTorque += FVector::CrossProduct(Arm, PointForce);
+        }
+
+        return Force;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBuoyancyFloatFrameTest, "BuoyancyPlugin.FloatFrame.FarFromOrigin",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBuoyancyFloatFrameTest::RunTest(const FString& Parameters)
+{
+    using namespace BuoyancyFloatFrameTest;
+
+    TArray<FVector3f> Points;
+    float VolumePerPoint = 0.0f;
+    MakeBoxPoints(Points, VolumePerPoint);
+
+    BuoyancyMath::FPointFrame Frame;
+    const BuoyancyMath::FPointForceResult AtOrigin = FloatInFrame(Points, VolumePerPoint, FVector::ZeroVector, Frame);
+    const FVector OriginForce = FVector(AtOrigin.Force + AtOrigin.SlammingForce);
+    const FVector OriginTorque = FVector(AtOrigin.Torque + AtOrigin.SlammingTorque);
+
+    const TArray<float> OriginWaterHeights = Frame.WaterHeight;
+
+    TestTrue(TEXT("Body is partly submerged at the origin"), AtOrigin.NumSubmerged > 0 && AtOrigin.NumSubmerged < Points.Num());
+
+    // The submerged force must not depend on where in the world the water is
+    for (const FVector& WaterOrigin : { FVector(1.0e7), FVector(-1.0e7), FVector(1.0e7, -1.0e7, 0.0) })
+    {
+        const BuoyancyMath::FPointForceResult FarAway = FloatInFrame(Points, VolumePerPoint, WaterOrigin, Frame);
+        const FVector Force = FVector(FarAway.Force + FarAway.SlammingForce);
+        const FVector Torque = FVector(FarAway.Torque + FarAway.SlammingTorque);
+
+        // A float has a whole centimetre of precision at 10^7 cm, so heights narrowed before the origin is subtracted would be off by up to half of that
+        float MaxHeightError = 0.0f;
+        for (int32 i = 0; i < Frame.Num(); i++)
+        {
+            MaxHeightError = FMath::Max(MaxHeightError, FMath::Abs(Frame.WaterHeight[i] - OriginWaterHeights[i]));
+        }
+
+        TestTrue(FString::Printf(TEXT("Water heights in the frame at %s match the origin (off by %f cm)"), *WaterOrigin.ToString(), MaxHeightError),
+                 MaxHeightError < 1.0e-3f);
+
+        TestEqual(FString::Printf(TEXT("Submerged points at %s"), *WaterOrigin.ToString()), FarAway.NumSubmerged, AtOrigin.NumSubmerged);
+        TestTrue(FString::Printf(TEXT("Force at %s matches the origin"), *WaterOrigin.ToString()),
+                 Force.Equals(OriginForce, OriginForce.Size() * 1.0e-5));
+        TestTrue(FString::Printf(TEXT("Torque at %s matches the origin"), *WaterOrigin.ToString()),
+                 Torque.Equals(OriginTorque, FMath::Max(OriginTorque.Size() * 1.0e-5, 1.0)));
+    }
+
+    // Against the double precision world path far from the origin
+    TArray<FVector> WorldPoints;
+    for (const FVector3f& Point : Points)
+    {
+        WorldPoints.Add(FVector(Point));
+    }
+
+    FVector DoubleTorque;
+    const FVector DoubleForce = FloatInWorldDoubles(WorldPoints, VolumePerPoint, FVector(1.0e7), DoubleTorque);
+    TestTrue(TEXT("Float frame force matches the double precision world path"), OriginForce.Equals(DoubleForce, DoubleForce.Size() * 1.0e-4));
+
+    // Timing, for information only: both paths sample the test waves, the water plugin queries that dominate the runtime cost are not included
+    double StartTime = FPlatformTime::Seconds();
+    FVector3f FrameSum = FVector3f::ZeroVector;
+    for (int32 i = 0; i < TimingIterations; i++)
+    {
+        FrameSum += FloatInFrame(Points, VolumePerPoint, FVector(1.0e7), Frame).Force;
+    }
+    const double FrameSeconds = FPlatformTime::Seconds() - StartTime;
+
+    StartTime = FPlatformTime::Seconds();
+    FVector DoubleSum = FVector::ZeroVector;
+    for (int32 i = 0; i < TimingIterations; i++)
+    {
+        DoubleSum += FloatInWorldDoubles(WorldPoints, VolumePerPoint, FVector(1.0e7), DoubleTorque);
+    }
+    const double DoubleSeconds = FPlatformTime::Seconds() - StartTime;
+
+    AddInfo(FString::Printf(TEXT("%d points x %d, without water plugin queries: float frame %.2f ms, world doubles %.2f ms, %.2fx (checksums %.0f, %.0f)"),
+                            Points.Num(), TimingIterations, FrameSeconds * 1000.0, DoubleSeconds * 1000.0,
+                            DoubleSeconds / FMath::Max(FrameSeconds, 1.0e-9), FrameSum.Z, DoubleSum.Z));
+
+    return true;
+}
+
+#endif
@@ -1,228 +1,977 @@
 #include "WaterPhysicsComponent.h"
+#include "BuoyancyWaterSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/SphereComponent.h"
 #include "DrawDebugHelpers.h"
-#include "EngineUtils.h"
+#include "Engine/CollisionProfile.h"
+#include "HydrostaticTable.h"
+#include "BuoyancyMath.h"
+#include "BuoyancyPointBudget.h"
+#include "GameFramework/GameStateBase.h"
+#include "Interfaces/Interface_AssetUserData.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
 #include "PhysicsEngine/BodySetup.h"
 
+DECLARE_STATS_GROUP(TEXT("Buoyancy"), STATGROUP_Buoyancy, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Apply Buoyancy"), STAT_ApplyBuoyancy, STATGROUP_Buoyancy);
+DECLARE_CYCLE_STAT(TEXT("Floating Instances"), STAT_FloatingInstances, STATGROUP_Buoyancy);
+DECLARE_CYCLE_STAT(TEXT("Follow Server State"), STAT_FollowServerState, STATGROUP_Buoyancy);
+DECLARE_CYCLE_STAT(TEXT("Debug Draw"), STAT_BuoyancyDebugDraw, STATGROUP_Buoyancy);
+
+namespace WaterPhysics
+{
+    /** Forces of every buoyancy body that moves one simulated body, welded parts share their parent's */
+    struct FTargetForces
+    {
+        FBodyInstance* BodyInstance = nullptr;
+        
+        /** Buoyancy and drag about the centre of mass */
+        FVector Force = FVector::ZeroVector;
+        FVector Torque = FVector::ZeroVector;
+        
+        FVector SlammingForce = FVector::ZeroVector;
+        FVector SlammingTorque = FVector::ZeroVector;
+        float EnteringSpeedVolume = 0.0f;
+        
+        float SubmergedVolume = 0.0f;
+        float TotalVolume = 0.0f;
+    };
+    
+    /** Whether the component hangs under a simulating body, which already carries it on the water */
+    static bool IsAttachedToSimulatingBody(const USceneComponent* Component)
+    {
+        for (const USceneComponent* Parent = Component->GetAttachParent(); Parent; Parent = Parent->GetAttachParent())
+        {
+            const UPrimitiveComponent* ParentPrimitive = Cast<UPrimitiveComponent>(Parent);
+            if (ParentPrimitive && ParentPrimitive->IsSimulatingPhysics())
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+}
+
+bool UWaterPhysicsComponent::IsBuoyancyPrimitive(const UPrimitiveComponent* Component)
+{
+    if (Component->IsA<UInstancedStaticMeshComponent>())
+    {
+        return false;
+    }
+    
+    return Component->IsA<UBoxComponent>() || Component->IsA<USphereComponent>()
+        || Component->IsA<UCapsuleComponent>() || Component->IsA<UStaticMeshComponent>();
+}
+
+UObject* UWaterPhysicsComponent::GetHydrostaticShape(UPrimitiveComponent* Component, FKAggregateGeom& OutAggGeom)
+{
+    if (UBoxComponent* BoxComponent = Cast<UBoxComponent>(Component))
+    {
+        FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
+        OutAggGeom.BoxElems.Add(FKBoxElem(BoxExtent.X * 2.0f, BoxExtent.Y * 2.0f, BoxExtent.Z * 2.0f));
+        return BoxComponent;
+    }
+    
+    if (USphereComponent* SphereComponent = Cast<USphereComponent>(Component))
+    {
+        OutAggGeom.SphereElems.Add(FKSphereElem(SphereComponent->GetUnscaledSphereRadius()));
+        return SphereComponent;
+    }
+    
+    if (UCapsuleComponent* CapsuleComponent = Cast<UCapsuleComponent>(Component))
+    {
+        float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
+        float CylinderLength = (CapsuleComponent->GetUnscaledCapsuleHalfHeight() - CapsuleRadius) * 2.0f;
+        OutAggGeom.SphylElems.Add(FKSphylElem(CapsuleRadius, CylinderLength));
+        return CapsuleComponent;
+    }
+    
+    if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+    {
+        UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
+        if (StaticMesh && StaticMesh->GetBodySetup())
+        {
+            OutAggGeom = StaticMesh->GetBodySetup()->AggGeom;
+            return StaticMesh;
+        }
+    }
+    
+    return nullptr;
+}
+
 UWaterPhysicsComponent::UWaterPhysicsComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
 }
 
+void UWaterPhysicsComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+    
+    DOREPLIFETIME(UWaterPhysicsComponent, ReplicatedState);
+}
+
 void UWaterPhysicsComponent::BeginPlay()
 {
     Super::BeginPlay();
     
     UE_LOG(LogTemp, Warning, TEXT("WATER PHYSICS COMPONENT BEGIN PLAY!!!"));
     
-    UBoxComponent* BoxComponent = GetOwner()->FindComponentByClass<UBoxComponent>();
+    WaterSubsystem = GetWorld()->GetSubsystem<UBuoyancyWaterSubsystem>();
+    
+    const ENetMode NetMode = GetNetMode();
     
-    if (BoxComponent)
+    // Nobody looks at a dedicated server, this also covers dedicated servers started from PIE
+    if (NetMode == NM_DedicatedServer)
     {
-        bIsBox = true;
+        bShowDebug = false;
+        bShowDetailedLogs = false;
         
-        UE_LOG(LogTemp, Warning, TEXT(" Found BoxComponent: %s"), *BoxComponent->GetName());
+        // Buoyancy runs at a reduced rate, the time between ticks is integrated as impulses
+        if (ServerTickInterval > 0.0f)
+        {
+            SetComponentTickInterval(ServerTickInterval);
+            bApplyAsImpulse = true;
+        }
+    }
+    
+    DiscoverBuoyancyBodies();
+    
+    // Clients follow the authoritative transform instead of simulating their own copy
+    bReplicatingState = NetMode != NM_Standalone && CanReplicateBuoyancyState();
+    bFollowServerState = bReplicatingState && NetMode == NM_Client;
+    
+    // Only components that send their state are replicated, the others cost the server nothing
+    if (bReplicatingState && GetOwner()->HasAuthority())
+    {
+        SetIsReplicated(true);
+    }
+    
+    if (bFollowServerState)
+    {
+        if (UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent()))
+        {
+            RootPrimitive->SetSimulatePhysics(false);
+        }
+    }
+    
+    if (BuoyancyBodies.Num() > 0 || FloatingInstanceSets.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT(" Floating %d bodies with %d buoyancy points and %d instanced meshes"), BuoyancyBodies.Num(), BuoyancyPoints.Num(), FloatingInstanceSets.Num());
         
-        if (!BoxComponent->IsSimulatingPhysics())
+        if (!bActivateNearWater || bFollowServerState)
         {
-            UE_LOG(LogTemp, Error, TEXT(" Enable 'Simulate Physics' on BoxComponent"));
-            BoxComponent->SetSimulatePhysics(true);
+            SetInWater(true);
+            return;
         }
         
-        UE_LOG(LogTemp, Warning, TEXT(" Box Collision Buoyancy Mode"));
-        UE_LOG(LogTemp, Warning, TEXT("   Mass: %.2f kg"), BoxComponent->GetMass());
+        // Overlaps wake the component up immediately, the periodic check catches water bodies without overlap events
+        GetOwner()->OnActorBeginOverlap.AddUniqueDynamic(this, &UWaterPhysicsComponent::OnOwnerBeginOverlap);
+        GetOwner()->OnActorEndOverlap.AddUniqueDynamic(this, &UWaterPhysicsComponent::OnOwnerEndOverlap);
+        
+        GetWorld()->GetTimerManager().SetTimer(ProximityTimerHandle, this, &UWaterPhysicsComponent::UpdateWaterActivation,
+                                               ProximityCheckInterval, true, FMath::FRandRange(0.0f, ProximityCheckInterval));
+        
+        UpdateWaterActivation();
+        return;
+    }
+    
+    SetComponentTickEnabled(false);
+    
+    UE_LOG(LogTemp, Error, TEXT(" No BoxComponent, SphereComponent, StaticMeshComponent, CapsuleComponent or SkeletalMeshComponent found"));
+    TArray<UActorComponent*> AllComponents;
+    GetOwner()->GetComponents(AllComponents);
+    UE_LOG(LogTemp, Error, TEXT("Available components:"));
+    for (UActorComponent* Comp : AllComponents)
+    {
+        UE_LOG(LogTemp, Error, TEXT("  - %s (%s)"), *Comp->GetName(), *Comp->GetClass()->GetName());
+    }
+}
+
+void UWaterPhysicsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (GetWorld())
+    {
+        GetWorld()->GetTimerManager().ClearTimer(ProximityTimerHandle);
+    }
+    
+    SetInWater(false);
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+void UWaterPhysicsComponent::UpdateWaterActivation()
+{
+    if (!WaterSubsystem || !GetOwner())
+    {
+        return;
+    }
+    
+    // Grow the bounds by the distance covered until the next check so fast falling objects aren't caught late
+    FBox ActorBounds = GetOwner()->GetComponentsBoundingBox();
+    if (!ActorBounds.IsValid)
+    {
+        ActorBounds = FBox(GetOwner()->GetActorLocation(), GetOwner()->GetActorLocation());
+    }
+    
+    FVector Travel = GetOwner()->GetVelocity().GetAbs() * ProximityCheckInterval;
+    ActorBounds = ActorBounds.ExpandBy(Travel + FVector(WaterProximityMargin));
+    
+    SetInWater(WaterSubsystem->IsNearWater(ActorBounds));
+    
+    // Away from water the component doesn't tick, keep clients roughly up to date from here
+    if (!bIsInWater)
+    {
+        UpdateReplicatedState();
+    }
+}
+
+void UWaterPhysicsComponent::SetInWater(bool bInWater)
+{
+    if (bIsInWater == bInWater)
+    {
+        SetComponentTickEnabled(bInWater);
+        return;
+    }
+    
+    bIsInWater = bInWater;
+    SetComponentTickEnabled(bInWater);
+    
+    if (WaterSubsystem)
+    {
+        WaterSubsystem->SetBuoyancyActive(bInWater);
+    }
+    
+#if BUOYANCY_WITH_DEBUG
+    if (bShowDetailedLogs)
+    {
+        UE_LOG(LogTemp, Warning, TEXT(" %s buoyancy on %s"), bInWater ? TEXT("Activated") : TEXT("Deactivated"), *GetOwner()->GetName());
+    }
+#endif
+}
+
+void UWaterPhysicsComponent::OnOwnerBeginOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+    if (Cast<AWaterBody>(OtherActor))
+    {
+        SetInWater(true);
+    }
+}
+
+void UWaterPhysicsComponent::OnOwnerEndOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+    if (Cast<AWaterBody>(OtherActor))
+    {
+        UpdateWaterActivation();
+    }
+}
+
+void UWaterPhysicsComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                          FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    
+    if (BuoyancyBodies.Num() == 0 && FloatingInstanceSets.Num() == 0)
+    {
+        return;
+    }
+    
+    if (bFollowServerState)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_FollowServerState);
+        FollowServerState();
+    }
+    else if (BuoyancyBodies.Num() > 0)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_ApplyBuoyancy);
+        ApplyBuoyancy(DeltaTime);
+        UpdateReplicatedState();
+    }
+    
+    if (FloatingInstanceSets.Num() > 0)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_FloatingInstances);
+        UpdateFloatingInstances(DeltaTime);
+    }
+    
+#if BUOYANCY_WITH_DEBUG
+    if (bShowDebug)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_BuoyancyDebugDraw);
+        DrawDebugInfo();
+    }
+#endif
+}
+
+bool UWaterPhysicsComponent::CanReplicateBuoyancyState() const
+{
+    const AActor* Owner = GetOwner();
+    
+    if (!bReplicateBuoyancyState || !Owner->GetIsReplicated() || BuoyancyBodies.Num() == 0)
+    {
+        return false;
+    }
+    
+    // Replicate Movement already writes the transform on clients, the two would fight over it
+    if (Owner->IsReplicatingMovement())
+    {
+        UE_LOG(LogTemp, Warning, TEXT(" %s replicates movement, not replicating its buoyancy state"), *Owner->GetName());
+        return false;
+    }
+    
+    // Only the root body is sent, any other simulated body would keep simulating on clients and drift
+    const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Owner->GetRootComponent());
+    const FBodyInstance* RootBody = RootPrimitive ? RootPrimitive->GetBodyInstance(NAME_None, true) : nullptr;
+    
+    for (const FBuoyancyBody& Body : BuoyancyBodies)
+    {
+        if (!RootBody || GetTargetBodyInstance(Body) != RootBody)
+        {
+            UE_LOG(LogTemp, Warning, TEXT(" %s floats bodies other than its root, not replicating its buoyancy state"), *Owner->GetName());
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void UWaterPhysicsComponent::UpdateReplicatedState()
+{
+    if (!bReplicatingState || !GetOwner()->HasAuthority())
+    {
+        return;
+    }
+    
+    const UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+    if (!RootPrimitive)
+    {
+        return;
+    }
+    
+    ReplicatedState.Location = RootPrimitive->GetComponentLocation();
+    ReplicatedState.Rotation = RootPrimitive->GetComponentRotation();
+    ReplicatedState.LinearVelocity = RootPrimitive->GetPhysicsLinearVelocity();
+    ReplicatedState.ServerTime = GetWorld()->GetTimeSeconds();
+}
+
+void UWaterPhysicsComponent::OnRep_ReplicatedState()
+{
+    ReceivedStates.Add(ReplicatedState);
+    
+    if (ReceivedStates.Num() > 8)
+    {
+        ReceivedStates.RemoveAt(0);
+    }
+}
+
+void UWaterPhysicsComponent::FollowServerState()
+{
+    USceneComponent* RootComponent = GetOwner()->GetRootComponent();
+    const AGameStateBase* GameState = GetWorld()->GetGameState();
+    
+    if (!RootComponent || !GameState || ReceivedStates.Num() == 0)
+    {
+        return;
+    }
+    
+    // Render slightly in the past so there is usually a newer state to interpolate towards
+    const float RenderTime = GameState->GetServerWorldTimeSeconds() - ClientInterpolationDelay;
+    
+    int32 FromIndex = 0;
+    while (FromIndex + 1 < ReceivedStates.Num() && ReceivedStates[FromIndex + 1].ServerTime <= RenderTime)
+    {
+        FromIndex++;
+    }
+    
+    const FBuoyancyReplicatedState& From = ReceivedStates[FromIndex];
+    FVector Location;
+    FQuat Rotation;
+    
+    if (FromIndex + 1 < ReceivedStates.Num())
+    {
+        const FBuoyancyReplicatedState& To = ReceivedStates[FromIndex + 1];
+        float Alpha = FMath::Clamp((RenderTime - From.ServerTime) / FMath::Max(To.ServerTime - From.ServerTime, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+        
+        Location = FMath::Lerp(FVector(From.Location), FVector(To.Location), Alpha);
+        Rotation = FQuat::Slerp(From.Rotation.Quaternion(), To.Rotation.Quaternion(), Alpha);
+    }
+    else
+    {
+        // Ran out of states, carry on along the last velocity for a little while
+        float Extrapolation = FMath::Clamp(RenderTime - From.ServerTime, 0.0f, 0.25f);
+        
+        Location = From.Location + From.LinearVelocity * Extrapolation;
+        Rotation = From.Rotation.Quaternion();
+    }
+    
+    RootComponent->SetWorldLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void UWaterPhysicsComponent::DiscoverBuoyancyBodies()
+{
+    BuoyancyBodies.Empty();
+    BuoyancyPoints.Empty();
+    FloatingInstanceSets.Empty();
+    bIsBox = bIsSphere = bIsCapsule = bIsStaticMesh = false;
+    
+    TArray<UPrimitiveComponent*> Primitives;
+    GetOwner()->GetComponents(Primitives);
+    
+    for (UPrimitiveComponent* Primitive : Primitives)
+    {
+        if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Primitive))
+        {
+            AddPhysicsAssetBodies(SkeletalMeshComponent);
+        }
+        else if (UInstancedStaticMeshComponent* InstancedMesh = Cast<UInstancedStaticMeshComponent>(Primitive))
+        {
+            if (bFloatInstances && !InstancedMesh->IsSimulatingPhysics() && !WaterPhysics::IsAttachedToSimulatingBody(InstancedMesh))
+            {
+                AddFloatingInstances(InstancedMesh);
+            }
+        }
+        else if (IsBuoyancyPrimitive(Primitive) && (Primitive->IsSimulatingPhysics() || Primitive->BodyInstance.WeldParent))
+        {
+            // Welded children keep their own points but push on the body they are welded to
+            AddPrimitiveBody(Primitive);
+        }
+    }
+    
+    if (BuoyancyBodies.Num() > 0 || FloatingInstanceSets.Num() > 0)
+    {
+        return;
+    }
+    
+    // Nothing simulates yet, fall back to the first collision in the usual order and turn physics on for it
+    UPrimitiveComponent* FallbackComponent = GetOwner()->FindComponentByClass<UBoxComponent>();
+    if (!FallbackComponent) FallbackComponent = GetOwner()->FindComponentByClass<USphereComponent>();
+    if (!FallbackComponent) FallbackComponent = GetOwner()->FindComponentByClass<UCapsuleComponent>();
+    if (!FallbackComponent) FallbackComponent = GetOwner()->FindComponentByClass<UStaticMeshComponent>();
+    
+    if (FallbackComponent && IsBuoyancyPrimitive(FallbackComponent))
+    {
+        UE_LOG(LogTemp, Error, TEXT(" Enable 'Simulate Physics' on %s"), *FallbackComponent->GetName());
+        FallbackComponent->SetSimulatePhysics(true);
+        AddPrimitiveBody(FallbackComponent);
+    }
+}
+
+void UWaterPhysicsComponent::AddPrimitiveBody(UPrimitiveComponent* Component)
+{
+    FBuoyancyBody& Body = BuoyancyBodies.AddDefaulted_GetRef();
+    Body.Component = Component;
+    Body.FirstPoint = BuoyancyPoints.Num();
+    
+    UE_LOG(LogTemp, Warning, TEXT(" Found %s: %s"), *Component->GetClass()->GetName(), *Component->GetName());
+    UE_LOG(LogTemp, Warning, TEXT("   Mass: %.2f kg"), Component->GetMass());
+    
+    if (UBoxComponent* BoxComponent = Cast<UBoxComponent>(Component))
+    {
+        bIsBox = true;
+        Body.Shape = EBuoyancyShape::Box;
         
         FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
         UE_LOG(LogTemp, Warning, TEXT("   Box Extents: (%.1f, %.1f, %.1f)"), BoxExtent.X, BoxExtent.Y, BoxExtent.Z);
+    }
+    else if (USphereComponent* SphereComponent = Cast<USphereComponent>(Component))
+    {
+        bIsSphere = true;
+        Body.Shape = EBuoyancyShape::Sphere;
+        
+        UE_LOG(LogTemp, Warning, TEXT("   Radius: %.1f"), SphereComponent->GetUnscaledSphereRadius());
+    }
+    else if (UCapsuleComponent* CapsuleComponent = Cast<UCapsuleComponent>(Component))
+    {
+        bIsCapsule = true;
+        Body.Shape = EBuoyancyShape::Capsule;
+        
+        UE_LOG(LogTemp, Warning, TEXT("   Radius: %.1f"), CapsuleComponent->GetUnscaledCapsuleRadius());
+        UE_LOG(LogTemp, Warning, TEXT("   Half Height: %.1f"), CapsuleComponent->GetUnscaledCapsuleHalfHeight());
+    }
+    else if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+    {
+        bIsStaticMesh = true;
+        Body.Shape = EBuoyancyShape::StaticMesh;
+        
+        UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
+        if (!StaticMesh)
+        {
+            UE_LOG(LogTemp, Error, TEXT("No mesh assigned"));
+        }
+        else if (!StaticMesh->GetBodySetup())
+        {
+            UE_LOG(LogTemp, Error, TEXT("Mesh has no collision setup"));
+        }
+        else
+        {
+            FBoxSphereBounds Bounds = StaticMesh->GetBounds();
+            UE_LOG(LogTemp, Warning, TEXT("   Mesh: %s"), *StaticMesh->GetName());
+            UE_LOG(LogTemp, Warning, TEXT("   Bounds: (%.1f, %.1f, %.1f)"), Bounds.BoxExtent.X, Bounds.BoxExtent.Y, Bounds.BoxExtent.Z);
+        }
+    }
+    
+    BuildPrimitivePointSet(Component, PointsPerAxis, BuoyancyPoints, Body.VolumePerPoint, Body.SubmersionHeight);
+    
+    Body.NumPoints = BuoyancyPoints.Num() - Body.FirstPoint;
+    UE_LOG(LogTemp, Warning, TEXT(" Generated %d buoyancy points with %d points per axis"), Body.NumPoints, PointsPerAxis);
+    
+    if (bShowDetailedLogs)
+    {
+        for (int32 i = Body.FirstPoint; i < FMath::Min(Body.FirstPoint + 5, BuoyancyPoints.Num()); i++)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("   Point %d: %s"), i - Body.FirstPoint, *BuoyancyPoints[i].ToString());
+        }
+    }
+    
+    if (bUseHydrostaticTable)
+    {
+        FKAggregateGeom AggGeom;
+        if (IInterface_AssetUserData* UserDataOwner = Cast<IInterface_AssetUserData>(GetHydrostaticShape(Component, AggGeom)))
+        {
+            Body.HydrostaticTable = UserDataOwner->GetAssetUserData<UHydrostaticTable>();
+        }
+        
+        if (Body.HydrostaticTable && !Body.HydrostaticTable->IsBaked())
+        {
+            Body.HydrostaticTable = nullptr;
+        }
+        
+        UE_LOG(LogTemp, Warning, TEXT("   Hydrostatic table: %s"), Body.HydrostaticTable ? TEXT("found") : TEXT("not baked, using buoyancy points"));
+    }
+}
+
+bool UWaterPhysicsComponent::BuildPrimitivePointSet(const UPrimitiveComponent* Component, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints,
+                                                    float& OutVolumePerPoint, float& OutSubmersionHeight)
+{
+    const int32 FirstPoint = OutPoints.Num();
+    InPointsPerAxis = FMath::Max(2, InPointsPerAxis);
+    
+    if (const UBoxComponent* BoxComponent = Cast<UBoxComponent>(Component))
+    {
+        FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
+        GenerateBoxBuoyancyPoints(BoxExtent, InPointsPerAxis, OutPoints);
+        
+        FVector PointSize = (BoxExtent * 2.0f) / InPointsPerAxis;
+        OutVolumePerPoint = PointSize.X * PointSize.Y * PointSize.Z;
+        OutSubmersionHeight = PointSize.Z;
+        return true;
+    }
+    
+    if (const USphereComponent* SphereComponent = Cast<USphereComponent>(Component))
+    {
+        float SphereRadius = SphereComponent->GetUnscaledSphereRadius();
+        GenerateSphereBuoyancyPoints(SphereRadius, InPointsPerAxis, OutPoints);
+        
+        float TotalSphereVolume = (4.0f/3.0f) * PI * FMath::Pow(SphereRadius, 3);
+        OutVolumePerPoint = TotalSphereVolume / FMath::Max(1, OutPoints.Num() - FirstPoint);
+        OutSubmersionHeight = SphereRadius / InPointsPerAxis;
+        return true;
+    }
+    
+    if (const UCapsuleComponent* CapsuleComponent = Cast<UCapsuleComponent>(Component))
+    {
+        float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
+        float CapsuleHalfHeight = CapsuleComponent->GetUnscaledCapsuleHalfHeight();
+        GenerateCapsuleBuoyancyPoints(CapsuleRadius, CapsuleHalfHeight, InPointsPerAxis, OutPoints);
+        
+        // Capsule volume = cylinder + 2 hemispheres = π(r²)h + (4/3)π(r³)
+        float CylinderHeight = (CapsuleHalfHeight - CapsuleRadius) * 2.0f;
+        float TotalVolume = PI * CapsuleRadius * CapsuleRadius * CylinderHeight + (4.0f/3.0f) * PI * FMath::Pow(CapsuleRadius, 3);
+        OutVolumePerPoint = TotalVolume / FMath::Max(1, OutPoints.Num() - FirstPoint);
+        OutSubmersionHeight = CapsuleRadius * 2.0f;
+        return true;
+    }
+    
+    if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+    {
+        const UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
+        if (!StaticMesh || !StaticMesh->GetBodySetup())
+        {
+            return false;
+        }
+        
+        return BuildAggGeomPointSet(StaticMesh->GetBodySetup()->AggGeom, InPointsPerAxis, OutPoints, OutVolumePerPoint, OutSubmersionHeight);
+    }
+    
+    return false;
+}
+
+bool UWaterPhysicsComponent::BuildAggGeomPointSet(const FKAggregateGeom& AggGeom, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints,
+                                                  float& OutVolumePerPoint, float& OutSubmersionHeight)
+{
+    // Points sample the inside of the collision on a grid, so the resolution sets both their number and volume
+    TArray<FVector> Cells;
+    const FVector CellSize = UHydrostaticTable::Voxelize(AggGeom, InPointsPerAxis, Cells);
+    
+    if (Cells.Num() > 0)
+    {
+        for (const FVector& Cell : Cells)
+        {
+            OutPoints.Add(FVector3f(Cell));
+        }
+        
+        OutVolumePerPoint = CellSize.X * CellSize.Y * CellSize.Z;
+        OutSubmersionHeight = FMath::Max(CellSize.Z, 1.0f);
+        return true;
+    }
+    
+    if (CellSize.IsZero())
+    {
+        return false;
+    }
+    
+    // Thin collision can fall between the cell centres of a coarse grid, use its vertices and share the real volume between them
+    const int32 FirstPoint = OutPoints.Num();
+    GenerateAggGeomBuoyancyPoints(AggGeom, OutPoints);
+    
+    OutVolumePerPoint = AggGeom.GetScaledVolume(FVector::OneVector) / FMath::Max(1, OutPoints.Num() - FirstPoint);
+    OutSubmersionHeight = FMath::Max(CellSize.Z, 1.0f);
+    return true;
+}
+
+void UWaterPhysicsComponent::AddPhysicsAssetBodies(USkeletalMeshComponent* SkeletalMeshComponent)
+{
+    UE_LOG(LogTemp, Warning, TEXT(" Found SkeletalMeshComponent: %s with %d bodies"), *SkeletalMeshComponent->GetName(), SkeletalMeshComponent->Bodies.Num());
+    
+    for (int32 BodyIndex = 0; BodyIndex < SkeletalMeshComponent->Bodies.Num(); BodyIndex++)
+    {
+        FBodyInstance* BodyInstance = SkeletalMeshComponent->Bodies[BodyIndex];
+        UBodySetup* BodySetup = BodyInstance ? BodyInstance->GetBodySetup() : nullptr;
+        
+        if (!BodySetup)
+        {
+            continue;
+        }
+        
+        FBuoyancyBody& Body = BuoyancyBodies.AddDefaulted_GetRef();
+        Body.Component = SkeletalMeshComponent;
+        Body.BodyIndex = BodyIndex;
+        Body.Shape = EBuoyancyShape::PhysicsAssetBody;
+        Body.FirstPoint = BuoyancyPoints.Num();
+        
+        // Same grid as static meshes, so rotated capsules are sampled along the bone and displace their own volume
+        BuildAggGeomPointSet(BodySetup->AggGeom, FMath::Max(2, PointsPerAxis), BuoyancyPoints, Body.VolumePerPoint, Body.SubmersionHeight);
+        Body.NumPoints = BuoyancyPoints.Num() - Body.FirstPoint;
+        
+        UE_LOG(LogTemp, Warning, TEXT("   Body: %s, %d points"), *BodySetup->BoneName.ToString(), Body.NumPoints);
+    }
+}
+
+void UWaterPhysicsComponent::AddFloatingInstances(UInstancedStaticMeshComponent* InstancedMesh)
+{
+    UStaticMesh* StaticMesh = InstancedMesh->GetStaticMesh();
+    const int32 NumInstances = InstancedMesh->GetInstanceCount();
+    
+    if (!StaticMesh || NumInstances == 0)
+    {
+        return;
+    }
+    
+    UE_LOG(LogTemp, Warning, TEXT(" Found %s: %s with %d instances"), *InstancedMesh->GetClass()->GetName(), *InstancedMesh->GetName(), NumInstances);
+    
+    FFloatingInstanceSet& InstanceSet = FloatingInstanceSets.AddDefaulted_GetRef();
+    InstanceSet.Component = InstancedMesh;
+    
+    FBox MeshBounds = StaticMesh->GetBoundingBox();
+    InstanceSet.HalfExtent = FVector2D(MeshBounds.GetExtent().X, MeshBounds.GetExtent().Y);
+    InstanceSet.WaterlineOffset = MeshBounds.Min.Z + MeshBounds.GetSize().Z * InstanceDraftRatio;
+    
+    InstanceSet.RestTransforms.SetNumUninitialized(NumInstances);
+    InstanceSet.InstanceTransforms.SetNumUninitialized(NumInstances);
+    InstanceSet.Heave.SetNumUninitialized(NumInstances);
+    InstanceSet.HeaveVelocity.SetNumZeroed(NumInstances);
+    InstanceSet.Pitch.SetNumZeroed(NumInstances);
+    InstanceSet.PitchVelocity.SetNumZeroed(NumInstances);
+    InstanceSet.Roll.SetNumZeroed(NumInstances);
+    InstanceSet.RollVelocity.SetNumZeroed(NumInstances);
+    InstanceSet.Promoted.Init(false, NumInstances);
+    
+    // Rest transforms stay relative to the component so the instances follow the actor when it moves
+    const FTransform ComponentTransform = InstancedMesh->GetComponentTransform();
+    
+    for (int32 i = 0; i < NumInstances; i++)
+    {
+        FTransform InstanceTransform;
+        InstancedMesh->GetInstanceTransform(i, InstanceTransform, false);
+        
+        InstanceSet.RestTransforms[i] = InstanceTransform;
+        InstanceSet.InstanceTransforms[i] = InstanceTransform;
+        InstanceSet.Heave[i] = (InstanceTransform * ComponentTransform).GetLocation().Z;
+    }
+    
+    if (bPromoteInstancesOnHit && InstancedMesh->IsCollisionEnabled())
+    {
+        InstancedMesh->SetNotifyRigidBodyCollision(true);
+        InstancedMesh->OnComponentHit.AddUniqueDynamic(this, &UWaterPhysicsComponent::OnInstancedMeshHit);
+    }
+}
+
+void UWaterPhysicsComponent::UpdateFloatingInstances(float DeltaTime)
+{
+    // Large frame spikes would make the explicit springs overshoot
+    DeltaTime = FMath::Min(DeltaTime, 1.0f / 30.0f);
+    
+    if (!WaterSubsystem)
+    {
+        return;
+    }
+    
+    for (FFloatingInstanceSet& InstanceSet : FloatingInstanceSets)
+    {
+        if (!IsValid(InstanceSet.Component))
+        {
+            continue;
+        }
+        
+        const FTransform ComponentTransform = InstanceSet.Component->GetComponentTransform();
+        const int32 NumInstances = InstanceSet.RestTransforms.Num();
+        int32 FirstDirty = INDEX_NONE;
+        
+        // Only contiguous runs of updated instances are written back, promoted and dry ones are left alone
+        auto FlushDirtyTransforms = [&InstanceSet, &FirstDirty]()
+        {
+            if (FirstDirty != INDEX_NONE)
+            {
+                InstanceSet.Component->BatchUpdateInstancesTransforms(FirstDirty, InstanceSet.DirtyTransforms, false, true, false);
+                InstanceSet.DirtyTransforms.Reset();
+                FirstDirty = INDEX_NONE;
+            }
+        };
+        
+        for (int32 i = 0; i < NumInstances; i++)
+        {
+            if (InstanceSet.Promoted[i])
+            {
+                FlushDirtyTransforms();
+                continue;
+            }
+            
+            const FTransform RestTransform = InstanceSet.RestTransforms[i] * ComponentTransform;
+            const FVector Scale = RestTransform.GetScale3D();
+            const float Yaw = RestTransform.Rotator().Yaw;
+            const FQuat YawRotation = FRotator(0.0f, Yaw, 0.0f).Quaternion();
+            
+            float HalfLength = FMath::Max(InstanceSet.HalfExtent.X * Scale.X, 1.0f);
+            float HalfWidth = FMath::Max(InstanceSet.HalfExtent.Y * Scale.Y, 1.0f);
+            
+            FVector Center = FVector(RestTransform.GetLocation().X, RestTransform.GetLocation().Y, InstanceSet.Heave[i]);
+            
+            // Resolve the water body once per instance, and leave instances outside every water body where they are
+            if (!WaterSubsystem->IsInsideWaterBody(InstanceSet.WaterBodyIndex, Center))
+            {
+                InstanceSet.WaterBodyIndex = WaterSubsystem->FindWaterBodyIndex(Center);
+                
+                if (!WaterSubsystem->IsInsideWaterBody(InstanceSet.WaterBodyIndex, Center))
+                {
+                    FlushDirtyTransforms();
+                    continue;
+                }
+            }
+            
+            float CenterHeight = WaterSubsystem->GetWaterHeightAtLocation(InstanceSet.WaterBodyIndex, Center);
+            float FrontHeight = WaterSubsystem->GetWaterHeightAtLocation(InstanceSet.WaterBodyIndex, Center + YawRotation.GetForwardVector() * HalfLength);
+            float SideHeight = WaterSubsystem->GetWaterHeightAtLocation(InstanceSet.WaterBodyIndex, Center + YawRotation.GetRightVector() * HalfWidth);
+            
+            // Positive roll lowers the right side, so a higher right sample needs a negative roll
+            float TargetHeave = CenterHeight - InstanceSet.WaterlineOffset * Scale.Z;
+            float TargetPitch = FMath::RadiansToDegrees(FMath::Atan2(FrontHeight - CenterHeight, HalfLength));
+            float TargetRoll = -FMath::RadiansToDegrees(FMath::Atan2(SideHeight - CenterHeight, HalfWidth));
+            
+            InstanceSet.HeaveVelocity[i] += (InstanceHeaveStiffness * (TargetHeave - InstanceSet.Heave[i]) - InstanceHeaveDamping * InstanceSet.HeaveVelocity[i]) * DeltaTime;
+            InstanceSet.PitchVelocity[i] += (InstanceTiltStiffness * (TargetPitch - InstanceSet.Pitch[i]) - InstanceTiltDamping * InstanceSet.PitchVelocity[i]) * DeltaTime;
+            InstanceSet.RollVelocity[i] += (InstanceTiltStiffness * (TargetRoll - InstanceSet.Roll[i]) - InstanceTiltDamping * InstanceSet.RollVelocity[i]) * DeltaTime;
+            
+            InstanceSet.Heave[i] += InstanceSet.HeaveVelocity[i] * DeltaTime;
+            InstanceSet.Pitch[i] += InstanceSet.PitchVelocity[i] * DeltaTime;
+            InstanceSet.Roll[i] += InstanceSet.RollVelocity[i] * DeltaTime;
+            
+            FTransform WorldTransform = FTransform(
+                FRotator(InstanceSet.Pitch[i], Yaw, InstanceSet.Roll[i]),
+                FVector(Center.X, Center.Y, InstanceSet.Heave[i]),
+                Scale
+            );
+            
+            InstanceSet.InstanceTransforms[i] = WorldTransform.GetRelativeTransform(ComponentTransform);
+            
+            if (FirstDirty == INDEX_NONE)
+            {
+                FirstDirty = i;
+            }
+            InstanceSet.DirtyTransforms.Add(InstanceSet.InstanceTransforms[i]);
+        }
+        
+        FlushDirtyTransforms();
+    }
+}
+
+UStaticMeshComponent* UWaterPhysicsComponent::PromoteInstance(UInstancedStaticMeshComponent* InstancedMesh, int32 InstanceIndex)
+{
+    FFloatingInstanceSet* InstanceSet = FloatingInstanceSets.FindByPredicate([InstancedMesh](const FFloatingInstanceSet& Set)
+    {
+        return Set.Component == InstancedMesh;
+    });
+    
+    if (!InstanceSet || !InstanceSet->RestTransforms.IsValidIndex(InstanceIndex) || InstanceSet->Promoted[InstanceIndex])
+    {
+        return nullptr;
+    }
+    
+    FTransform InstanceTransform = InstanceSet->InstanceTransforms[InstanceIndex] * InstancedMesh->GetComponentTransform();
+    
+    UStaticMeshComponent* PromotedMesh = NewObject<UStaticMeshComponent>(GetOwner());
+    PromotedMesh->SetStaticMesh(InstancedMesh->GetStaticMesh());
+    PromotedMesh->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+    PromotedMesh->SetWorldTransform(InstanceTransform);
+    PromotedMesh->RegisterComponent();
+    GetOwner()->AddInstanceComponent(PromotedMesh);
+    
+    // Hide the instance first so the new body doesn't spawn inside its collision
+    InstanceSet->Promoted[InstanceIndex] = true;
+    InstanceSet->InstanceTransforms[InstanceIndex].SetScale3D(FVector::ZeroVector);
+    InstancedMesh->UpdateInstanceTransform(InstanceIndex, InstanceSet->InstanceTransforms[InstanceIndex], false, true, true);
+    
+    PromotedMesh->SetSimulatePhysics(true);
+    PromotedMesh->SetPhysicsLinearVelocity(FVector(0.0f, 0.0f, InstanceSet->HeaveVelocity[InstanceIndex]));
+    
+    UE_LOG(LogTemp, Warning, TEXT(" Promoted instance %d of %s to a physics body"), InstanceIndex, *InstancedMesh->GetName());
+    
+    AddPrimitiveBody(PromotedMesh);
+    return PromotedMesh;
+}
 
-        PhysicsComp = BoxComponent;
-        
-        GenerateBuoyancyPoints();
+void UWaterPhysicsComponent::OnInstancedMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+                                                FVector NormalImpulse, const FHitResult& Hit)
+{
+    UInstancedStaticMeshComponent* InstancedMesh = Cast<UInstancedStaticMeshComponent>(HitComponent);
+    
+    if (!InstancedMesh || !OtherComp || !OtherComp->IsSimulatingPhysics())
+    {
         return;
     }
     
-    USphereComponent* SphereComponent = GetOwner()->FindComponentByClass<USphereComponent>();
+    TArray<int32> HitInstances = InstancedMesh->GetInstancesOverlappingSphere(Hit.ImpactPoint, InstancePromotionRadius, true);
     
-    if (SphereComponent)
+    for (int32 InstanceIndex : HitInstances)
     {
-        bIsSphere = true;
-        UE_LOG(LogTemp, Warning, TEXT(" Found SphereComponent: %s"), *SphereComponent->GetName());
-        
-        if (!SphereComponent->IsSimulatingPhysics())
-        {
-            UE_LOG(LogTemp, Error, TEXT(" Enable 'Simulate Physics' on SphereComponent"));
-            SphereComponent->SetSimulatePhysics(true);
-        }
-        
-        UE_LOG(LogTemp, Warning, TEXT(" Sphere Collision Buoyancy Mode"));
-        UE_LOG(LogTemp, Warning, TEXT("   Mass: %.2f kg"), SphereComponent->GetMass());
-        UE_LOG(LogTemp, Warning, TEXT("   Radius: %.1f"), SphereComponent->GetUnscaledSphereRadius());
-
-        PhysicsComp = SphereComponent;
-        
-        GenerateBuoyancyPoints();
-        return;
+        PromoteInstance(InstancedMesh, InstanceIndex);
     }
+}
 
-    UCapsuleComponent* CapsuleComponent = GetOwner()->FindComponentByClass<UCapsuleComponent>();
+void UWaterPhysicsComponent::BakeHydrostaticTable()
+{
+    AActor* Owner = GetOwner();
+    if (!Owner) return;
+    
+    TArray<UPrimitiveComponent*> Primitives;
+    Owner->GetComponents(Primitives);
+    
+    int32 TablesBaked = 0;
     
-    if (CapsuleComponent)
+    for (UPrimitiveComponent* Primitive : Primitives)
     {
-        bIsCapsule = true;
-        UE_LOG(LogTemp, Warning, TEXT(" Found CapsuleComponent: %s"), *CapsuleComponent->GetName());
-        
-        if (!CapsuleComponent->IsSimulatingPhysics())
+        if (!IsBuoyancyPrimitive(Primitive))
         {
-            UE_LOG(LogTemp, Error, TEXT(" Enable 'Simulate Physics' on CapsuleComponent"));
-            CapsuleComponent->SetSimulatePhysics(true);
+            continue;
         }
         
-        UE_LOG(LogTemp, Warning, TEXT(" Capsule Collision Buoyancy Mode"));
-        UE_LOG(LogTemp, Warning, TEXT("   Mass: %.2f kg"), CapsuleComponent->GetMass());
-        UE_LOG(LogTemp, Warning, TEXT("   Radius: %.1f"), CapsuleComponent->GetUnscaledCapsuleRadius());
-        UE_LOG(LogTemp, Warning, TEXT("   Half Height: %.1f"), CapsuleComponent->GetUnscaledCapsuleHalfHeight());
-
-        PhysicsComp = CapsuleComponent;
-        
-        GenerateBuoyancyPoints();
-        return;
-    }
-
-    UStaticMeshComponent* StaticMeshComponent = GetOwner()->FindComponentByClass<UStaticMeshComponent>();
-    
-    if (StaticMeshComponent)
-    {
-        bIsStaticMesh = true;
+        FKAggregateGeom AggGeom;
+        UObject* TableOwner = GetHydrostaticShape(Primitive, AggGeom);
+        IInterface_AssetUserData* UserDataOwner = Cast<IInterface_AssetUserData>(TableOwner);
         
-        UE_LOG(LogTemp, Warning, TEXT(" Found StaticMeshComponent: %s"), *StaticMeshComponent->GetName());
-
-        if (!StaticMeshComponent->IsSimulatingPhysics())
+        if (!UserDataOwner)
         {
-            UE_LOG(LogTemp, Error, TEXT(" Enable 'Simulate Physics' on StaticMeshComponent"));
-            StaticMeshComponent->SetSimulatePhysics(true);
+            UE_LOG(LogTemp, Error, TEXT("Cannot bake hydrostatic table for %s: mesh has no collision setup"), *Primitive->GetName());
+            continue;
         }
         
-        UE_LOG(LogTemp, Warning, TEXT(" Static Mesh Mode"));
-        UE_LOG(LogTemp, Warning, TEXT("   Mass: %.2f kg"), StaticMeshComponent->GetMass());
-
-        if (StaticMeshComponent->GetStaticMesh())
+        UHydrostaticTable* Table = NewObject<UHydrostaticTable>(TableOwner, NAME_None, RF_Transactional);
+        Table->Bake(AggGeom, HydrostaticDraftSteps, HydrostaticPitchSteps, HydrostaticRollSteps, HydrostaticVoxelResolution);
+        
+        if (!Table->IsBaked())
         {
-            UE_LOG(LogTemp, Warning, TEXT("   Mesh: %s"), *StaticMeshComponent->GetStaticMesh()->GetName());
-            FBoxSphereBounds Bounds = StaticMeshComponent->GetStaticMesh()->GetBounds();
-            UE_LOG(LogTemp, Warning, TEXT("   Bounds: (%.1f, %.1f, %.1f)"), Bounds.BoxExtent.X, Bounds.BoxExtent.Y, Bounds.BoxExtent.Z);
+            continue;
         }
-
-        PhysicsComp = StaticMeshComponent;
         
-        GenerateBuoyancyPoints();
-        return;
+        TableOwner->Modify();
+        UserDataOwner->RemoveUserDataOfClass(UHydrostaticTable::StaticClass());
+        UserDataOwner->AddAssetUserData(Table);
+        TablesBaked++;
+        
+        UE_LOG(LogTemp, Warning, TEXT(" Stored hydrostatic table on %s"), *TableOwner->GetName());
     }
     
-    PhysicsComp->SetAngularDamping(AngularDamping);
-    PhysicsComp->SetLinearDamping(LinearDamping);
-    
-    UE_LOG(LogTemp, Error, TEXT(" No BoxComponent, SphereComponent, StaticMeshComponent or CapsuleComponent found"));
-    TArray<UActorComponent*> AllComponents;
-    GetOwner()->GetComponents(AllComponents);
-    UE_LOG(LogTemp, Error, TEXT("Available components:"));
-    for (UActorComponent* Comp : AllComponents)
+    if (TablesBaked == 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("  - %s (%s)"), *Comp->GetName(), *Comp->GetClass()->GetName());
+        UE_LOG(LogTemp, Error, TEXT("Cannot bake hydrostatic table: no BoxComponent, SphereComponent, CapsuleComponent or StaticMeshComponent found"));
     }
 }
 
-void UWaterPhysicsComponent::TickComponent(float DeltaTime, ELevelTick TickType, 
-                                          FActorComponentTickFunction* ThisTickFunction)
+void UWaterPhysicsComponent::TunePointBudget()
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    AActor* Owner = GetOwner();
+    if (!Owner) return;
     
-    if (!PhysicsComp)
-    {
-        UE_LOG(LogTemp, Error, TEXT(" No physics component has been found"));
-        return;
-    }
+    TArray<UPrimitiveComponent*> Primitives;
+    Owner->GetComponents(Primitives);
     
-    if (!PhysicsComp->IsSimulatingPhysics())
+    FBuoyancyPointBudgetResult Result = FBuoyancyPointBudgetTuner(this).Tune(Primitives);
+    
+    if (!Result.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT(" Physics not simulating on %s"), *PhysicsComp->GetName());
+        UE_LOG(LogTemp, Error, TEXT("Cannot tune point budget: no BoxComponent, SphereComponent, CapsuleComponent or StaticMeshComponent found"));
         return;
     }
-
-    ApplyBuoyancy(DeltaTime);
     
-    if (bShowDebug)
-    {
-        DrawDebugInfo();
-    }
-}
-
-void UWaterPhysicsComponent::GenerateBuoyancyPoints()
-{
-    if (bIsSphere)
-    {
-        GenerateSphereBuoyancyPoints();
-    }
-    else if (bIsBox)
-    {
-        GenerateBoxBuoyancyPoints();
-    }
-    else if (bIsCapsule)
+    UE_LOG(LogTemp, Warning, TEXT(" Tuned on the floated collision: %s"), *FString::Join(Result.TunedPrimitives, TEXT(", ")));
+    
+    for (const FBuoyancyPointBudgetSample& Sample : Result.Samples)
     {
-        GenerateCapsuleBuoyancyPoints();
+        UE_LOG(LogTemp, Warning, TEXT("   %d points per axis: %d points, draft error %.1f%%, tilt error %.2f deg%s"),
+               Sample.PointsPerAxis, Sample.NumPoints, Sample.DraftError * 100.0f, Sample.TiltError, Sample.bWithinTolerance ? TEXT("") : TEXT(" (out of tolerance)"));
     }
-    else
+    
+    if (!Result.Best.bWithinTolerance)
     {
-        GenerateStaticMeshBuoyancyPoints();
+        UE_LOG(LogTemp, Error, TEXT(" No setting up to %d points per axis is within tolerance, using the most accurate one"), MaxPointsPerAxis);
     }
+    
+    Modify();
+    PointsPerAxis = Result.Best.PointsPerAxis;
+    
+    UE_LOG(LogTemp, Warning, TEXT(" Points per axis %d -> %d, %d -> %d points"),
+           Result.Current.PointsPerAxis, Result.Best.PointsPerAxis, Result.Current.NumPoints, Result.Best.NumPoints);
 }
 
-void UWaterPhysicsComponent::GenerateBoxBuoyancyPoints()
+void UWaterPhysicsComponent::GenerateBoxBuoyancyPoints(const FVector& BoxExtent, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints)
 {
-    UE_LOG(LogTemp, Warning, TEXT("GENERATING BOX BUOYANCY POINTS!!!"));
-    BuoyancyPoints.Empty();
-    UBoxComponent* BoxComponent = GetOwner()->FindComponentByClass<UBoxComponent>();
-    
-    FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
-    UE_LOG(LogTemp, Warning, TEXT("Box Extents: (%.1f, %.1f, %.1f)"), BoxExtent.X, BoxExtent.Y, BoxExtent.Z);
-    UE_LOG(LogTemp, Warning, TEXT("Points Per Axis: %d"), PointsPerAxis);
-    
-    for (int32 X = 0; X < PointsPerAxis; X++)
+    for (int32 X = 0; X < InPointsPerAxis; X++)
     {
-        for (int32 Y = 0; Y < PointsPerAxis; Y++)
+        for (int32 Y = 0; Y < InPointsPerAxis; Y++)
         {
-            for (int32 Z = 0; Z < PointsPerAxis; Z++)
+            for (int32 Z = 0; Z < InPointsPerAxis; Z++)
             {
                 FVector LocalPosition = FVector(
-                    BoxExtent.X * (2.0f * X / (PointsPerAxis - 1) - 1.0f),
-                    BoxExtent.Y * (2.0f * Y / (PointsPerAxis - 1) - 1.0f),
-                    BoxExtent.Z * (2.0f * Z / (PointsPerAxis - 1) - 1.0f)
+                    BoxExtent.X * (2.0f * X / (InPointsPerAxis - 1) - 1.0f),
+                    BoxExtent.Y * (2.0f * Y / (InPointsPerAxis - 1) - 1.0f),
+                    BoxExtent.Z * (2.0f * Z / (InPointsPerAxis - 1) - 1.0f)
                 );
                 
-                BuoyancyPoints.Add(LocalPosition);
+                OutPoints.Add(FVector3f(LocalPosition));
             }
         }
     }
-    
-    UE_LOG(LogTemp, Warning, TEXT(" Generated %d buoyancy points"), BuoyancyPoints.Num());
-    
-    for (int32 i = 0; i < FMath::Min(5, BuoyancyPoints.Num()); i++)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("   Point %d: %s"), i, *BuoyancyPoints[i].ToString());
-    }
 }
 
-void UWaterPhysicsComponent::GenerateSphereBuoyancyPoints()
+void UWaterPhysicsComponent::GenerateSphereBuoyancyPoints(float SphereRadius, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints)
 {
-    UE_LOG(LogTemp, Warning, TEXT("GENERATING SPHERE BUOYANCY POINTS!!!"));
-    USphereComponent* SphereComponent = GetOwner()->FindComponentByClass<USphereComponent>();
-    
-    float SphereRadius = SphereComponent->GetUnscaledSphereRadius();
-    int32 ShellNum = PointsPerAxis;
+    int32 ShellNum = InPointsPerAxis;
     
     for (int32 Shell = 0; Shell < ShellNum; Shell++)
     {
         float ShellRadius = SphereRadius * (Shell + 1.0f) / ShellNum;
-        int32 PointsInShell = FMath::Max(8, PointsPerAxis * PointsPerAxis * (Shell + 1) / ShellNum);
+        int32 PointsInShell = FMath::Max(8, InPointsPerAxis * InPointsPerAxis * (Shell + 1) / ShellNum);
         
         float GoldenRatio = (1.0f + FMath::Sqrt(5.0f)) / 2.0f;
         
@@ -237,46 +986,23 @@ void UWaterPhysicsComponent::GenerateSphereBuoyancyPoints()
                 ShellRadius * FMath::Cos(Phi)
             );
             
-            BuoyancyPoints.Add(LocalPosition);
+            OutPoints.Add(FVector3f(LocalPosition));
         }
     }
     
-    BuoyancyPoints.Add(FVector::ZeroVector);
-    
-    UE_LOG(LogTemp, Warning, TEXT(" Generated %d sphere points"), BuoyancyPoints.Num());
+    OutPoints.Add(FVector3f::ZeroVector);
 }
 
-void UWaterPhysicsComponent::GenerateStaticMeshBuoyancyPoints()
+void UWaterPhysicsComponent::GenerateAggGeomBuoyancyPoints(const FKAggregateGeom& AggGeom, TArray<FVector3f>& OutPoints)
 {
-    UE_LOG(LogTemp, Warning, TEXT("GENERATING STATIC MESH BUOYANCY POINTS"));
-    UStaticMeshComponent* StaticMeshComponent = GetOwner()->FindComponentByClass<UStaticMeshComponent>();
-    
-    if (!StaticMeshComponent->GetStaticMesh())
-    {
-        UE_LOG(LogTemp, Error, TEXT("No mesh assigned"));
-        return;
-    }
-    
-    UBodySetup* BodySetup = StaticMeshComponent->GetStaticMesh()->GetBodySetup();
-    if (!BodySetup)
-    {
-        UE_LOG(LogTemp, Error, TEXT("Mesh has no collision setup"));
-        return;
-    }
-    
-    UE_LOG(LogTemp, Warning, TEXT("Mesh: %s"), *StaticMeshComponent->GetStaticMesh()->GetName());
-    UE_LOG(LogTemp, Warning, TEXT("Extracting points from collision geometry"));
-    
-    int32 PointsAdded = 0;
-    
-    for (const FKConvexElem& ConvexElem : BodySetup->AggGeom.ConvexElems)
+    // Points are built in each element's own space and moved by its transform, like the debug draw
+    for (const FKConvexElem& ConvexElem : AggGeom.ConvexElems)
     {
-        UE_LOG(LogTemp, Warning, TEXT("  Convex hull with %d vertices"), ConvexElem.VertexData.Num());
+        const FTransform ElemTransform = ConvexElem.GetTransform();
         
         for (const FVector& Vertex : ConvexElem.VertexData)
         {
-            BuoyancyPoints.Add(Vertex);
-            PointsAdded++;
+            OutPoints.Add(FVector3f(ElemTransform.TransformPosition(Vertex)));
         }
         
         FVector HullCenter = FVector::ZeroVector;
@@ -287,17 +1013,14 @@ void UWaterPhysicsComponent::GenerateStaticMeshBuoyancyPoints()
         if (ConvexElem.VertexData.Num() > 0)
         {
             HullCenter /= ConvexElem.VertexData.Num();
-            BuoyancyPoints.Add(HullCenter);
-            PointsAdded++;
+            OutPoints.Add(FVector3f(ElemTransform.TransformPosition(HullCenter)));
         }
     }
     
-    for (const FKBoxElem& BoxElem : BodySetup->AggGeom.BoxElems)
+    for (const FKBoxElem& BoxElem : AggGeom.BoxElems)
     {
-        UE_LOG(LogTemp, Warning, TEXT("  Box collision found"));
-        
         FVector BoxExtent = FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f;
-        FVector BoxCenter = BoxElem.Center;
+        const FTransform ElemTransform = BoxElem.GetTransform();
         
         for (int32 X = 0; X < 3; X++)
         {
@@ -305,22 +1028,19 @@ void UWaterPhysicsComponent::GenerateStaticMeshBuoyancyPoints()
             {
                 for (int32 Z = 0; Z < 3; Z++)
                 {
-                    FVector LocalPos = BoxCenter + FVector(
+                    FVector LocalPos = FVector(
                         BoxExtent.X * (X - 1),
                         BoxExtent.Y * (Y - 1),
                         BoxExtent.Z * (Z - 1)
                     );
-                    BuoyancyPoints.Add(LocalPos);
-                    PointsAdded++;
+                    OutPoints.Add(FVector3f(ElemTransform.TransformPosition(LocalPos)));
                 }
             }
         }
     }
     
-    for (const FKSphereElem& SphereElem : BodySetup->AggGeom.SphereElems)
+    for (const FKSphereElem& SphereElem : AggGeom.SphereElems)
     {
-        UE_LOG(LogTemp, Warning, TEXT("  Sphere collision found"));
-        
         int32 NumLayers = 3;
         for (int32 Layer = 0; Layer < NumLayers; Layer++)
         {
@@ -337,18 +1057,16 @@ void UWaterPhysicsComponent::GenerateStaticMeshBuoyancyPoints()
                     LayerRadius * FMath::Sin(Angle),
                     LayerHeight
                 );
-                BuoyancyPoints.Add(LocalPos);
-                PointsAdded++;
+                OutPoints.Add(FVector3f(LocalPos));
             }
         }
     }
     
-    for (const FKSphylElem& CapsuleElem : BodySetup->AggGeom.SphylElems)
+    for (const FKSphylElem& CapsuleElem : AggGeom.SphylElems)
     {
-        UE_LOG(LogTemp, Warning, TEXT("  Capsule collision found"));
-        
         float HalfHeight = CapsuleElem.Length * 0.5f;
         float Radius = CapsuleElem.Radius;
+        const FTransform ElemTransform = CapsuleElem.GetTransform();
         
         int32 HeightSegments = 5;
         int32 RadialSegments = 8;
@@ -360,42 +1078,25 @@ void UWaterPhysicsComponent::GenerateStaticMeshBuoyancyPoints()
             for (int32 R = 0; R < RadialSegments; R++)
             {
                 float Angle = 2.0f * PI * R / RadialSegments;
-                FVector LocalPos = CapsuleElem.Center + FVector(
+                // Sphyl elements run along their local Z, the rotation lays them along the bone
+                FVector LocalPos = FVector(
                     Radius * FMath::Cos(Angle),
                     Radius * FMath::Sin(Angle),
                     Height
                 );
-                BuoyancyPoints.Add(LocalPos);
-                PointsAdded++;
+                OutPoints.Add(FVector3f(ElemTransform.TransformPosition(LocalPos)));
             }
         }
     }
-    
-    UE_LOG(LogTemp, Warning, TEXT(" Generated %d buoyancy points from collision geometry"), PointsAdded);
-    
-    if (bShowDetailedLogs && BuoyancyPoints.Num() > 0)
-    {
-        for (int32 i = 0; i < FMath::Min(5, BuoyancyPoints.Num()); i++)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("   Point %d: %s"), i, *BuoyancyPoints[i].ToString());
-        }
-    }
 }
 
-void UWaterPhysicsComponent::GenerateCapsuleBuoyancyPoints()
+void UWaterPhysicsComponent::GenerateCapsuleBuoyancyPoints(float CapsuleRadius, float CapsuleHalfHeight, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints)
 {
-    UE_LOG(LogTemp, Warning, TEXT("GENERATING CAPSULE BUOYANCY POINTS!!!"));
-    UCapsuleComponent* CapsuleComponent = GetOwner()->FindComponentByClass<UCapsuleComponent>();
-    
-    float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
-    float CapsuleHalfHeight = CapsuleComponent->GetUnscaledCapsuleHalfHeight();
     float CylinderHeight = CapsuleHalfHeight - CapsuleRadius;
     
-    UE_LOG(LogTemp, Warning, TEXT("Capsule: Radius=%.1f, HalfHeight=%.1f"), CapsuleRadius, CapsuleHalfHeight);
-    
-    int32 HeightSegments = PointsPerAxis * 2;
-    int32 RadialSegments = PointsPerAxis * 3;
-    int32 RadialLayers = PointsPerAxis;
+    int32 HeightSegments = InPointsPerAxis * 2;
+    int32 RadialSegments = InPointsPerAxis * 3;
+    int32 RadialLayers = InPointsPerAxis;
     
     for (int32 H = 0; H < HeightSegments; H++)
     {
@@ -414,12 +1115,12 @@ void UWaterPhysicsComponent::GenerateCapsuleBuoyancyPoints()
                     LayerRadius * FMath::Sin(Angle),
                     Height
                 );
-                BuoyancyPoints.Add(LocalPos);
+                OutPoints.Add(FVector3f(LocalPos));
             }
         }
     }
     
-    int32 HemispherePoints = PointsPerAxis * PointsPerAxis;
+    int32 HemispherePoints = InPointsPerAxis * InPointsPerAxis;
     for (int32 i = 0; i < HemispherePoints; i++)
     {
         float Theta = 2.0f * PI * i / HemispherePoints;
@@ -430,7 +1131,7 @@ void UWaterPhysicsComponent::GenerateCapsuleBuoyancyPoints()
             CapsuleRadius * FMath::Sin(Phi) * FMath::Sin(Theta),
             CylinderHeight + CapsuleRadius * FMath::Cos(Phi)
         );
-        BuoyancyPoints.Add(LocalPos);
+        OutPoints.Add(FVector3f(LocalPos));
     }
     
     for (int32 i = 0; i < HemispherePoints; i++)
@@ -443,323 +1144,417 @@ void UWaterPhysicsComponent::GenerateCapsuleBuoyancyPoints()
             CapsuleRadius * FMath::Sin(Phi) * FMath::Sin(Theta),
             -CylinderHeight - CapsuleRadius * FMath::Cos(Phi)
         );
-        BuoyancyPoints.Add(LocalPos);
+        OutPoints.Add(FVector3f(LocalPos));
+    }
+    
+    OutPoints.Add(FVector3f::ZeroVector);
+}
+
+FBodyInstance* UWaterPhysicsComponent::GetTargetBodyInstance(const FBuoyancyBody& Body) const
+{
+    if (!IsValid(Body.Component))
+    {
+        return nullptr;
+    }
+    
+    if (Body.BodyIndex != INDEX_NONE)
+    {
+        USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Body.Component);
+        return SkeletalMeshComponent && SkeletalMeshComponent->Bodies.IsValidIndex(Body.BodyIndex) ? SkeletalMeshComponent->Bodies[Body.BodyIndex] : nullptr;
     }
     
-    BuoyancyPoints.Add(FVector::ZeroVector);
+    return Body.Component->GetBodyInstance(NAME_None, true);
+}
+
+FTransform UWaterPhysicsComponent::GetBodyTransform(const FBuoyancyBody& Body) const
+{
+    if (Body.BodyIndex != INDEX_NONE)
+    {
+        FBodyInstance* BodyInstance = GetTargetBodyInstance(Body);
+        return BodyInstance ? BodyInstance->GetUnrealWorldTransform() : FTransform::Identity;
+    }
     
-    UE_LOG(LogTemp, Warning, TEXT(" Generated %d capsule points"), BuoyancyPoints.Num());
+    return Body.Component->GetComponentTransform();
 }
 
 void UWaterPhysicsComponent::ApplyBuoyancy(float DeltaTime)
 {
+#if BUOYANCY_WITH_DEBUG
     int32 UnderwaterPoints = 0;
     float TotalForceApplied = 0.0f;
-    USphereComponent* SphereComponent = GetOwner()->FindComponentByClass<USphereComponent>();
+#endif
+    
+    // Drag acts on the mass of displaced water, the mass that buoyancy holds up against gravity
+    const float GravityZ = GetWorld()->GetGravityZ();
+    const float GravityMagnitude = FMath::Max(-GravityZ, KINDA_SMALL_NUMBER);
+    
+    // Welded parts share their parent's body, forces are summed per simulated body and applied once
+    TArray<WaterPhysics::FTargetForces, TInlineAllocator<8>> Targets;
     
-    if (bIsSphere)
+    // One pass over every body's points
+    for (FBuoyancyBody& Body : BuoyancyBodies)
     {
-        float SphereRadius = SphereComponent->GetUnscaledSphereRadius();
-        float TotalSphereVolume = (4.0f/3.0f) * PI * FMath::Pow(SphereRadius, 3);
-        float VolumePerPoint = TotalSphereVolume / FMath::Max(1, BuoyancyPoints.Num());
+        Body.Force = FVector::ZeroVector;
+        Body.Torque = FVector::ZeroVector;
         
-        for (const FVector& LocalPoint : BuoyancyPoints)
+        FBodyInstance* TargetBody = GetTargetBodyInstance(Body);
+        if (!TargetBody || !TargetBody->IsInstanceSimulatingPhysics())
         {
-            FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
-            float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
-            
-            if (WorldPoint.Z < WaterHeight)
-            {
-                UnderwaterPoints++;
-                float SubmersionDepth = WaterHeight - WorldPoint.Z;
-                float SubmersionRatio = FMath::Clamp(SubmersionDepth / (SphereRadius / PointsPerAxis), 0.0f, 1.0f);
-                float SubmergedVolume = VolumePerPoint * SubmersionRatio;
-                float BuoyancyForce = (SubmergedVolume / 1000.0f) * 9.8f * BuoyancyForceMultiplier * WaterDensity;
-                TotalForceApplied += BuoyancyForce;
-                
-                PhysicsComp->AddForceAtLocation(FVector(0, 0, BuoyancyForce), WorldPoint);
-            }
+            continue;
         }
-    }
-    else if (bIsBox)
-    {
-        UBoxComponent* BoxComponent = GetOwner()->FindComponentByClass<UBoxComponent>();
         
-        FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
-        float PointSizeX = (BoxExtent.X * 2.0f) / PointsPerAxis;
-        float PointSizeY = (BoxExtent.Y * 2.0f) / PointsPerAxis;
-        float PointSizeZ = (BoxExtent.Z * 2.0f) / PointsPerAxis;
+        WaterPhysics::FTargetForces* Target = Targets.FindByPredicate([TargetBody](const WaterPhysics::FTargetForces& Forces)
+        {
+            return Forces.BodyInstance == TargetBody;
+        });
         
-        for (const FVector& LocalPoint : BuoyancyPoints)
+        if (!Target)
         {
-            FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
-            float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
-            
-            if (WorldPoint.Z < WaterHeight)
-            {
-                UnderwaterPoints++;
-                float SubmersionDepth = WaterHeight - WorldPoint.Z;
-                float SubmergedHeight = FMath::Min(SubmersionDepth, PointSizeZ);
-                float SubmergedVolume = PointSizeX * PointSizeY * SubmergedHeight;
-                float BuoyancyForce = (SubmergedVolume / 1000.0f) * 9.8f * BuoyancyForceMultiplier * WaterDensity;
-                TotalForceApplied += BuoyancyForce;
-                
-                PhysicsComp->AddForceAtLocation(FVector(0, 0, BuoyancyForce), WorldPoint);
-            }
+            Target = &Targets.AddDefaulted_GetRef();
+            Target->BodyInstance = TargetBody;
         }
-    }
-    else if (bIsStaticMesh)
-    {
-        UStaticMeshComponent* StaticMeshComponent = GetOwner()->FindComponentByClass<UStaticMeshComponent>();
-        FBoxSphereBounds MeshBounds = StaticMeshComponent->GetStaticMesh()->GetBounds();
-        FVector MeshExtent = MeshBounds.BoxExtent;
         
-        float PointSizeX = (MeshExtent.X * 2.0f) / PointsPerAxis;
-        float PointSizeY = (MeshExtent.Y * 2.0f) / PointsPerAxis;
-        float PointSizeZ = (MeshExtent.Z * 2.0f) / PointsPerAxis;
+        const FVector CenterOfMass = TargetBody->GetCOMPosition();
         
-        for (int32 i = 0; i < BuoyancyPoints.Num(); i++)
+        if (Body.HydrostaticTable)
         {
-            const FVector& LocalPoint = BuoyancyPoints[i];
-            FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
-            float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
+            ApplyHydrostaticBuoyancy(Body, TargetBody, CenterOfMass, Target->SubmergedVolume, Target->TotalVolume);
+        }
+        else
+        {
+            Target->TotalVolume += Body.NumPoints * Body.VolumePerPoint;
             
-            if (bShowDetailedLogs && i < 3)
+            // The water body is resolved once per body and all its points are queried in one batch
+            const int32 WaterBodyIndex = WaterSubsystem ? WaterSubsystem->FindWaterBodyIndex(CenterOfMass) : INDEX_NONE;
+            if (WaterBodyIndex == INDEX_NONE)
             {
-                UE_LOG(LogTemp, Log, TEXT("Mesh Point %d: World(%.1f,%.1f,%.1f) Water(%.1f)"), 
-                       i, WorldPoint.X, WorldPoint.Y, WorldPoint.Z, WaterHeight);
+                continue;
             }
             
-            if (WorldPoint.Z < WaterHeight)
+            const FTransform BodyTransform = GetBodyTransform(Body);
+            
+            // Rebase into a float frame at the body, level with the water body under it. Only the water
+            // query and the summed force and torque go back to world doubles
+            const FVector FrameOrigin = WaterSubsystem->GetWaterFrameOrigin(WaterBodyIndex, CenterOfMass);
+            const FTransform3f LocalTransform(FQuat4f(BodyTransform.GetRotation()), FVector3f(BodyTransform.GetLocation() - FrameOrigin), FVector3f(BodyTransform.GetScale3D()));
+            
+            BuoyancyMath::TransformPoints(LocalTransform, MakeArrayView(BuoyancyPoints.GetData() + Body.FirstPoint, Body.NumPoints), PointFrame);
+            WaterSubsystem->GetWaterHeightsInFrame(WaterBodyIndex, FrameOrigin, PointFrame);
+            
+#if BUOYANCY_WITH_DEBUG
+            if (bShowDetailedLogs)
             {
-                UnderwaterPoints++;
-                float SubmersionDepth = WaterHeight - WorldPoint.Z;
-                float SubmergedHeight = FMath::Min(SubmersionDepth, PointSizeZ);
-                float SubmergedVolume = PointSizeX * PointSizeY * SubmergedHeight;
-                float BuoyancyForce = (SubmergedVolume / 1000.0f) * 9.8f * BuoyancyForceMultiplier * WaterDensity;
-                TotalForceApplied += BuoyancyForce;
-                
-                if (bShowDetailedLogs && i < 3)
+                for (int32 i = 0; i < FMath::Min(PointFrame.Num(), 3); i++)
                 {
-                    UE_LOG(LogTemp, Warning, TEXT("   Depth: %.1f, Volume: %.1f, Force: %.1f"), 
-                           SubmersionDepth, SubmergedVolume, BuoyancyForce);
+                    FVector WorldPoint = FrameOrigin + FVector(PointFrame.X[i], PointFrame.Y[i], PointFrame.Z[i]);
+                    UE_LOG(LogTemp, Log, TEXT("%s Point %d: World(%.1f,%.1f,%.1f) Water(%.1f)"),
+                           *Body.Component->GetName(), i, WorldPoint.X, WorldPoint.Y, WorldPoint.Z, FrameOrigin.Z + PointFrame.WaterHeight[i]);
                 }
-                
-                PhysicsComp->AddForceAtLocation(FVector(0, 0, BuoyancyForce), WorldPoint);
             }
+#endif
+            
+            // Drag and slamming come from the body's velocity, no further queries per point
+            BuoyancyMath::FPointForceParams Params;
+            Params.CenterOfMass = FVector3f(CenterOfMass - FrameOrigin);
+            Params.LinearVelocity = FVector3f(TargetBody->GetUnrealWorldVelocity());
+            Params.AngularVelocity = FVector3f(TargetBody->GetUnrealWorldAngularVelocityInRadians());
+            Params.VolumePerPoint = Body.VolumePerPoint;
+            Params.SubmersionHeight = Body.SubmersionHeight;
+            Params.WaterDensity = WaterDensity;
+            Params.BuoyancyForceMultiplier = BuoyancyForceMultiplier;
+            Params.GravityMagnitude = GravityMagnitude;
+            Params.LinearDrag = LinearDamping;
+            Params.QuadraticDrag = QuadraticDrag;
+            Params.SlammingCoefficient = SlammingCoefficient;
+            
+            BuoyancyMath::FPointForceResult Result;
+            BuoyancyMath::AccumulatePointForces(PointFrame, Params, Result);
+            
+#if BUOYANCY_WITH_DEBUG
+            UnderwaterPoints += Result.NumSubmerged;
+#endif
+            
+            // The frame is only translated, its force and torque are already world aligned
+            Body.Force = FVector(Result.Force);
+            Body.Torque = FVector(Result.Torque);
+            
+            Target->SlammingForce += FVector(Result.SlammingForce);
+            Target->SlammingTorque += FVector(Result.SlammingTorque);
+            Target->EnteringSpeedVolume += Result.EnteringSpeedVolume;
+            Target->SubmergedVolume += Result.SubmergedVolume;
         }
         
+        Target->Force += Body.Force;
+        Target->Torque += Body.Torque;
     }
-    else if (bIsCapsule)
+    
+    for (WaterPhysics::FTargetForces& Target : Targets)
     {
-        UCapsuleComponent* CapsuleComponent = GetOwner()->FindComponentByClass<UCapsuleComponent>();
-        float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
-        float CapsuleHalfHeight = CapsuleComponent->GetUnscaledCapsuleHalfHeight();
+        FBodyInstance* TargetBody = Target.BodyInstance;
+        const float Mass = TargetBody->GetBodyMass();
         
-        // Capsule volume = cylinder + 2 hemispheres = π(r²)h + (4/3)π(r³)
-        float CylinderHeight = (CapsuleHalfHeight - CapsuleRadius) * 2.0f;
-        float TotalVolume = PI * CapsuleRadius * CapsuleRadius * CylinderHeight + (4.0f/3.0f) * PI * FMath::Pow(CapsuleRadius, 3);
-        float VolumePerPoint = TotalVolume / FMath::Max(1, BuoyancyPoints.Num());
+        // Limited once for the whole simulated body, against the entering points' momentum and everything else pushing it up
+        const float MaxSlammingForce = BuoyancyMath::GetMaxSlammingForce(Target.EnteringSpeedVolume, Target.TotalVolume, Target.Force.Z, Mass, GravityZ, DeltaTime);
+        if (Target.SlammingForce.Z > MaxSlammingForce)
+        {
+            const float SlammingScale = MaxSlammingForce / Target.SlammingForce.Z;
+            Target.SlammingForce *= SlammingScale;
+            Target.SlammingTorque *= SlammingScale;
+        }
+        
+        Target.Force += Target.SlammingForce;
+        Target.Torque += Target.SlammingTorque;
         
-        for (const FVector& LocalPoint : BuoyancyPoints)
+        // Rotational drag for the submerged share of the simulated body, once however many parts are welded to it
+        if (Target.TotalVolume > 0.0f && Target.SubmergedVolume > 0.0f)
         {
-            FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
-            float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
-            
-            if (WorldPoint.Z < WaterHeight)
+            Target.Torque -= TargetBody->GetUnrealWorldAngularVelocityInRadians() * AngularDamping * FMath::Min(Target.SubmergedVolume / Target.TotalVolume, 1.0f);
+        }
+        
+        if (Target.Force.IsZero() && Target.Torque.IsZero())
+        {
+            continue;
+        }
+        
+        if (bApplyAsImpulse)
+        {
+            // Reduced rate: push the momentum of every frame since the last tick at once
+            TargetBody->AddImpulse(Target.Force * DeltaTime, false);
+            TargetBody->AddAngularImpulseInRadians(Target.Torque * DeltaTime, false);
+        }
+        else
+        {
+            TargetBody->AddForce(Target.Force);
+            TargetBody->AddTorqueInRadians(Target.Torque);
+        }
+        
+#if BUOYANCY_WITH_DEBUG
+        TotalForceApplied += Target.Force.Z;
+#endif
+    }
+    
+#if BUOYANCY_WITH_DEBUG
+    if (TotalForceApplied > 0.0f && bShowDetailedLogs)
+    {
+        float TotalMass = 0.0f;
+        for (const FBuoyancyBody& Body : BuoyancyBodies)
+        {
+            // Welded parts report the mass of the body they are welded to, count it once
+            FBodyInstance* TargetBody = GetTargetBodyInstance(Body);
+            if (TargetBody && (Body.BodyIndex != INDEX_NONE || !Body.Component->BodyInstance.WeldParent))
             {
-                UnderwaterPoints++;
-                float SubmersionDepth = WaterHeight - WorldPoint.Z;
-                float SubmersionRatio = FMath::Clamp(SubmersionDepth / (CapsuleRadius * 2.0f), 0.0f, 1.0f);
-                float SubmergedVolume = VolumePerPoint * SubmersionRatio;
-                float BuoyancyForce = (SubmergedVolume / 1000.0f) * 9.8f * BuoyancyForceMultiplier * WaterDensity;
-                TotalForceApplied += BuoyancyForce;
-                
-                PhysicsComp->AddForceAtLocation(FVector(0, 0, BuoyancyForce), WorldPoint);
+                TotalMass += TargetBody->GetBodyMass();
             }
         }
+        
+        float WeightForce = TotalMass * 98.0f;
+        UE_LOG(LogTemp, Error, TEXT("Bouyancy report from the %s: Force: %.1f N | Weight: %.1f N | Ratio: %.2f | Underwater: %d/%d | Bodies: %d"),
+               *GetOwner()->GetName(), TotalForceApplied, WeightForce, TotalForceApplied / WeightForce, UnderwaterPoints, BuoyancyPoints.Num(), BuoyancyBodies.Num());
     }
+#endif
+}
 
-    if (UnderwaterPoints > 0 && bShowDetailedLogs)
+void UWaterPhysicsComponent::ApplyHydrostaticBuoyancy(FBuoyancyBody& Body, const FBodyInstance* TargetBody, const FVector& CenterOfMass,
+                                                      float& InOutSubmergedVolume, float& InOutTotalVolume)
+{
+    const UHydrostaticTable* Table = Body.HydrostaticTable;
+    const FTransform BodyTransform = GetBodyTransform(Body);
+    const FVector BodyLocation = BodyTransform.GetLocation();
+    const float BodyScale = BodyTransform.GetMaximumAxisScale();
+    const float SampleRadius = FMath::Max(Table->MaxDraft * BodyScale, 1.0f);
+    
+    InOutTotalVolume += Table->TotalVolume * BodyScale * BodyScale * BodyScale;
+    
+    // Fit a local water plane through three samples around the body
+    FVector WaterSamples[3];
+    for (int32 i = 0; i < 3; i++)
     {
-        float MeshMass = PhysicsComp->GetMass();
-        float WeightForce = MeshMass * 98.0f;
-        UE_LOG(LogTemp, Error, TEXT("Bouyancy report from the %s: Force: %.1f N | Weight: %.1f N | Ratio: %.2f | Underwater: %d/%d"), 
-               *PhysicsComp->GetName(), TotalForceApplied, WeightForce, TotalForceApplied / WeightForce, UnderwaterPoints, BuoyancyPoints.Num());
+        float Angle = 2.0f * PI * i / 3.0f;
+        FVector SampleLocation = BodyLocation + FVector(SampleRadius * FMath::Cos(Angle), SampleRadius * FMath::Sin(Angle), 0.0f);
+        SampleLocation.Z = GetWaterHeightAtLocation(SampleLocation);
+        
+        if (SampleLocation.Z <= -99999.0f)
+        {
+            return;
+        }
+        
+        WaterSamples[i] = SampleLocation;
     }
     
-    if (PhysicsComp)
+    FVector WaterNormal = FVector::CrossProduct(WaterSamples[1] - WaterSamples[0], WaterSamples[2] - WaterSamples[0]).GetSafeNormal();
+    if (WaterNormal.IsNearlyZero())
     {
-        ApplyDampingForces(DeltaTime);
+        WaterNormal = FVector::UpVector;
     }
-}
-
-void UWaterPhysicsComponent::ApplyDampingForces(float DeltaTime) const
-{
-    if (!PhysicsComp) return;
+    else if (WaterNormal.Z < 0.0f)
+    {
+        WaterNormal = -WaterNormal;
+    }
+    
+    // Yaw about the water normal doesn't change the submerged shape, only pitch and roll are looked up
+    FQuat WaterRotation = FQuat::FindBetweenNormals(FVector::UpVector, WaterNormal);
+    FRotator RelativeRotation = (WaterRotation.Inverse() * BodyTransform.GetRotation()).Rotator();
+    float Draft = FVector::DotProduct(WaterNormal, WaterSamples[0] - BodyLocation) / BodyScale;
+    
+    float SubmergedVolume = 0.0f;
+    FVector LocalCentre = FVector::ZeroVector;
+    Table->Lookup(Draft, RelativeRotation.Pitch, RelativeRotation.Roll, SubmergedVolume, LocalCentre);
+    SubmergedVolume *= BodyScale * BodyScale * BodyScale;
+    
+    if (SubmergedVolume <= 0.0f)
+    {
+        return;
+    }
+    
+    FVector CentreOfBuoyancy = BodyTransform.TransformPosition(LocalCentre);
+    FVector BuoyancyForce = FVector(0, 0, BuoyancyMath::GetBuoyancyForce(SubmergedVolume, WaterDensity, BuoyancyForceMultiplier));
+    
+    Body.Force += BuoyancyForce;
+    Body.Torque += FVector::CrossProduct(CentreOfBuoyancy - CenterOfMass, BuoyancyForce);
+    
+    // No points to drag, the whole displaced water is dragged at the centre of buoyancy
+    const float GravityMagnitude = FMath::Max(-GetWorld()->GetGravityZ(), KINDA_SMALL_NUMBER);
+    const FVector AngularVelocity = TargetBody->GetUnrealWorldAngularVelocityInRadians();
+    const FVector Arm = CentreOfBuoyancy - CenterOfMass;
+    const FVector Velocity = TargetBody->GetUnrealWorldVelocity() + FVector::CrossProduct(AngularVelocity, Arm);
+    const FVector DragForce = FVector(BuoyancyMath::GetDragForce(FVector3f(Velocity), BuoyancyForce.Z / GravityMagnitude, LinearDamping, QuadraticDrag));
     
-    FVector Velocity = PhysicsComp->GetPhysicsLinearVelocity();
-    FVector LinearDampingForce = -Velocity * LinearDamping * PhysicsComp->GetMass();
-    PhysicsComp->AddForce(LinearDampingForce);
+    Body.Force += DragForce;
+    Body.Torque += FVector::CrossProduct(Arm, DragForce);
+    InOutSubmergedVolume += SubmergedVolume;
     
-    FVector AngularVelocity = PhysicsComp->GetPhysicsAngularVelocityInRadians();
-    FVector AngularDampingTorque = -AngularVelocity * AngularDamping;
-    PhysicsComp->AddTorqueInRadians(AngularDampingTorque);
+#if BUOYANCY_WITH_DEBUG
+    if (bShowDetailedLogs)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Hydrostatic lookup for %s: Draft: %.1f | Pitch: %.1f | Roll: %.1f | Volume: %.1f"),
+               *Body.Component->GetName(), Draft, RelativeRotation.Pitch, RelativeRotation.Roll, SubmergedVolume);
+    }
+#endif
 }
 
 float UWaterPhysicsComponent::GetWaterHeightAtLocation(const FVector& WorldLocation) const
 {
-    if (!GetWorld()) return -99999.0f;
+    if (!WaterSubsystem) return -99999.0f;
     
-    for (TActorIterator<AWaterBody> WaterBodyIterator(GetWorld()); WaterBodyIterator; ++WaterBodyIterator)
+    return WaterSubsystem->GetWaterHeightAtLocation(WorldLocation);
+}
+
+void UWaterPhysicsComponent::DrawAggGeom(const FKAggregateGeom& AggGeom, const FTransform& BodyTransform) const
+{
+#if BUOYANCY_WITH_DEBUG
+    for (const FKConvexElem& ConvexElem : AggGeom.ConvexElems)
     {
-        AWaterBody* WaterBody = *WaterBodyIterator;
-        if (WaterBody && WaterBody->GetWaterBodyComponent())
+        for (int32 i = 0; i < ConvexElem.VertexData.Num(); i++)
         {
-            FVector WaterSurfaceLocation;
-            FVector WaterSurfaceNormal;
-            FVector WaterVelocity;
-            float WaterDepth;
-            
-            WaterBody->GetWaterBodyComponent()->GetWaterSurfaceInfoAtLocation(
-                WorldLocation,
-                WaterSurfaceLocation,
-                WaterSurfaceNormal,
-                WaterVelocity,
-                WaterDepth,
-                true
-            );
-            
-            float BaseWaterHeight = WaterSurfaceLocation.Z;
+            FVector V1 = BodyTransform.TransformPosition(ConvexElem.VertexData[i]);
             
-            if (UWaterWavesBase* WaterWaves = WaterBody->GetWaterWaves())
+            for (int32 j = i + 1; j < ConvexElem.VertexData.Num(); j++)
             {
-                float CurrentTime = GetWorld()->GetTimeSeconds();
-                float WaveDisplacement = WaterWaves->GetSimpleWaveHeightAtPosition(
-                    WorldLocation,
-                    WaterDepth,
-                    CurrentTime
-                );
+                FVector V2 = BodyTransform.TransformPosition(ConvexElem.VertexData[j]);
+                
+                float Distance = FVector::Dist(V1, V2);
+                float MaxEdgeLength = 200.0f;
                 
-                return BaseWaterHeight + WaveDisplacement;
+                if (Distance < MaxEdgeLength)
+                {
+                    DrawDebugLine(GetWorld(), V1, V2, FColor::Green, false, -1.0f, 0, 2.0f);
+                }
             }
-            
-            return BaseWaterHeight;
         }
     }
     
-    return -99999.0f;
+    for (const FKBoxElem& BoxElem : AggGeom.BoxElems)
+    {
+        FVector BoxCenter = BodyTransform.TransformPosition(BoxElem.Center);
+        FQuat BoxRot = BodyTransform.GetRotation() * BoxElem.Rotation.Quaternion();
+        FVector BoxExtent = FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f;
+        DrawDebugBox(GetWorld(), BoxCenter, BoxExtent, BoxRot, FColor::Green, false, -1.0f, 0, 2.0f);
+    }
+    
+    for (const FKSphereElem& SphereElem : AggGeom.SphereElems)
+    {
+        FVector SphereCenter = BodyTransform.TransformPosition(SphereElem.Center);
+        DrawDebugSphere(GetWorld(), SphereCenter, SphereElem.Radius, 16, FColor::Green, false, -1.0f, 0, 2.0f);
+    }
+    
+    for (const FKSphylElem& CapsuleElem : AggGeom.SphylElems)
+    {
+        FVector CapsuleCenter = BodyTransform.TransformPosition(CapsuleElem.Center);
+        FQuat CapsuleRot = BodyTransform.GetRotation() * CapsuleElem.Rotation.Quaternion();
+        DrawDebugCapsule(GetWorld(), CapsuleCenter, CapsuleElem.Length * 0.5f, CapsuleElem.Radius,
+                       CapsuleRot, FColor::Green, false, -1.0f, 0, 2.0f);
+    }
+#endif
 }
 
 void UWaterPhysicsComponent::DrawDebugInfo()
 {
+#if BUOYANCY_WITH_DEBUG
     if (!GetWorld()) return;
     
-    FVector ComponentCenter;
-    UStaticMeshComponent* StaticMeshComponent = GetOwner()->FindComponentByClass<UStaticMeshComponent>();
-    
-    if (bIsStaticMesh)
+    for (const FBuoyancyBody& Body : BuoyancyBodies)
     {
-        ComponentCenter = StaticMeshComponent->GetComponentLocation();
+        if (!IsValid(Body.Component))
+        {
+            continue;
+        }
+        
+        const FTransform BodyTransform = GetBodyTransform(Body);
+        FVector ComponentCenter = BodyTransform.GetLocation();
         
-        if (UBodySetup* BodySetup = StaticMeshComponent->GetStaticMesh()->GetBodySetup())
+        if (Body.Shape == EBuoyancyShape::StaticMesh)
         {
-            FTransform ComponentTransform = StaticMeshComponent->GetComponentTransform();
-            
-            for (const FKConvexElem& ConvexElem : BodySetup->AggGeom.ConvexElems)
-            {
-                for (int32 i = 0; i < ConvexElem.VertexData.Num(); i++)
-                {
-                    FVector V1 = ComponentTransform.TransformPosition(ConvexElem.VertexData[i]);
-                    
-                    for (int32 j = i + 1; j < ConvexElem.VertexData.Num(); j++)
-                    {
-                        FVector V2 = ComponentTransform.TransformPosition(ConvexElem.VertexData[j]);
-                        
-                        float Distance = FVector::Dist(V1, V2);
-                        float MaxEdgeLength = 200.0f;
-                        
-                        if (Distance < MaxEdgeLength)
-                        {
-                            DrawDebugLine(GetWorld(), V1, V2, FColor::Green, false, -1.0f, 0, 2.0f);
-                        }
-                    }
-                }
-            }
-            
-            for (const FKBoxElem& BoxElem : BodySetup->AggGeom.BoxElems)
-            {
-                FVector BoxCenter = ComponentTransform.TransformPosition(BoxElem.Center);
-                FQuat BoxRot = ComponentTransform.GetRotation() * BoxElem.Rotation.Quaternion();
-                FVector BoxExtent = FVector(BoxElem.X, BoxElem.Y, BoxElem.Z) * 0.5f;
-                DrawDebugBox(GetWorld(), BoxCenter, BoxExtent, BoxRot, FColor::Green, false, -1.0f, 0, 2.0f);
-            }
+            UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Body.Component);
+            UStaticMesh* StaticMesh = StaticMeshComponent ? StaticMeshComponent->GetStaticMesh() : nullptr;
             
-            for (const FKSphereElem& SphereElem : BodySetup->AggGeom.SphereElems)
+            if (StaticMesh && StaticMesh->GetBodySetup())
             {
-                FVector SphereCenter = ComponentTransform.TransformPosition(SphereElem.Center);
-                DrawDebugSphere(GetWorld(), SphereCenter, SphereElem.Radius, 16, FColor::Green, false, -1.0f, 0, 2.0f);
+                DrawAggGeom(StaticMesh->GetBodySetup()->AggGeom, BodyTransform);
             }
+        }
+        else if (Body.Shape == EBuoyancyShape::PhysicsAssetBody)
+        {
+            FBodyInstance* BodyInstance = GetTargetBodyInstance(Body);
             
-            for (const FKSphylElem& CapsuleElem : BodySetup->AggGeom.SphylElems)
+            if (BodyInstance && BodyInstance->GetBodySetup())
             {
-                FVector CapsuleCenter = ComponentTransform.TransformPosition(CapsuleElem.Center);
-                FQuat CapsuleRot = ComponentTransform.GetRotation() * CapsuleElem.Rotation.Quaternion();
-                DrawDebugCapsule(GetWorld(), CapsuleCenter, CapsuleElem.Length * 0.5f, CapsuleElem.Radius, 
-                               CapsuleRot, FColor::Green, false, -1.0f, 0, 2.0f);
+                DrawAggGeom(BodyInstance->GetBodySetup()->AggGeom, BodyTransform);
             }
         }
+        else if (USphereComponent* SphereComponent = Cast<USphereComponent>(Body.Component))
+        {
+            float SphereRadius = SphereComponent->GetUnscaledSphereRadius();
+            DrawDebugSphere(GetWorld(), ComponentCenter, SphereRadius, 16, FColor::Green, false, -1.0f, 0, 2.0f);
+        }
+        else if (UBoxComponent* BoxComponent = Cast<UBoxComponent>(Body.Component))
+        {
+            FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
+            FQuat BoxRotation = BoxComponent->GetComponentQuat();
+            DrawDebugBox(GetWorld(), ComponentCenter, BoxExtent, BoxRotation, FColor::Green, false, -1.0f, 0, 3.0f);
+        }
+        else if (UCapsuleComponent* CapsuleComponent = Cast<UCapsuleComponent>(Body.Component))
+        {
+            float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
+            float CapsuleHalfHeight = CapsuleComponent->GetUnscaledCapsuleHalfHeight();
+            FQuat CapsuleRotation = CapsuleComponent->GetComponentQuat();
+            DrawDebugCapsule(GetWorld(), ComponentCenter, CapsuleHalfHeight, CapsuleRadius,
+                           CapsuleRotation, FColor::Green, false, -1.0f, 0, 2.0f);
+        }
         
-        for (const FVector& LocalPoint : BuoyancyPoints)
+        for (int32 i = Body.FirstPoint; i < Body.FirstPoint + Body.NumPoints; i++)
         {
-            FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
+            FVector WorldPoint = BodyTransform.TransformPosition(FVector(BuoyancyPoints[i]));
             float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
             
             FColor PointColor = (WorldPoint.Z < WaterHeight) ? FColor::Red : FColor::Yellow;
             DrawDebugPoint(GetWorld(), WorldPoint, 8.0f, PointColor, false, -1.0f, 0);
         }
     }
-    else if (bIsSphere)
-    {
-        USphereComponent* SphereComponent = GetOwner()->FindComponentByClass<USphereComponent>();
-        ComponentCenter = SphereComponent->GetComponentLocation();
-        
-        float SphereRadius = SphereComponent->GetUnscaledSphereRadius();
-        DrawDebugSphere(GetWorld(), ComponentCenter, SphereRadius, 16, FColor::Green, false, -1.0f, 0, 2.0f);
-    }
-    else if (bIsBox)
-    {
-        UBoxComponent* BoxComponent = GetOwner()->FindComponentByClass<UBoxComponent>();
-        ComponentCenter = BoxComponent->GetComponentLocation();
-        
-        FVector BoxExtent = BoxComponent->GetUnscaledBoxExtent();
-        FQuat BoxRotation = BoxComponent->GetComponentQuat();
-        DrawDebugBox(GetWorld(), ComponentCenter, BoxExtent, BoxRotation, FColor::Green, false, -1.0f, 0, 3.0f);
-    }
-    else if (bIsCapsule)
-    {
-        UCapsuleComponent* CapsuleComponent = GetOwner()->FindComponentByClass<UCapsuleComponent>();
-        ComponentCenter = CapsuleComponent->GetComponentLocation();
-    
-        float CapsuleRadius = CapsuleComponent->GetUnscaledCapsuleRadius();
-        float CapsuleHalfHeight = CapsuleComponent->GetUnscaledCapsuleHalfHeight();
-        FQuat CapsuleRotation = CapsuleComponent->GetComponentQuat();
-        DrawDebugCapsule(GetWorld(), ComponentCenter, CapsuleHalfHeight, CapsuleRadius, 
-                       CapsuleRotation, FColor::Green, false, -1.0f, 0, 2.0f);
-    }
-
-    for (const FVector& LocalPoint : BuoyancyPoints)
-    {
-        FVector WorldPoint = GetOwner()->GetTransform().TransformPosition(LocalPoint);
-        float WaterHeight = GetWaterHeightAtLocation(WorldPoint);
-            
-        FColor PointColor = (WorldPoint.Z < WaterHeight) ? FColor::Red : FColor::Yellow;
-        DrawDebugPoint(GetWorld(), WorldPoint, 8.0f, PointColor, false, -1.0f, 0);
-    }
     
-    if (!PhysicsComp) return;
+    if (BuoyancyBodies.Num() == 0) return;
     
-    DrawDebugString(GetWorld(), ComponentCenter + FVector(0, 0, 150), 
-                   FString::Printf(TEXT("%d collision vertices"), BuoyancyPoints.Num()), 
+    DrawDebugString(GetWorld(), GetOwner()->GetActorLocation() + FVector(0, 0, 150),
+                   FString::Printf(TEXT("%d collision vertices, %d bodies"), BuoyancyPoints.Num(), BuoyancyBodies.Num()),
                    nullptr, FColor::White, -1.0f, true, 1.5f);
-}
\ No newline at end of file
+#endif
+}
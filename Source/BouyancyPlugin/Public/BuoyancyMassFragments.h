@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Templates/SubclassOf.h"
+#include "BuoyancyMassFragments.generated.h"
+
+class AActor;
+
+/** Buoyancy points of one shape, shared by every entity spawned from the same trait */
+USTRUCT()
+struct FBuoyancyMassPointSetFragment : public FMassConstSharedFragment
+{
+    GENERATED_BODY()
+
+    /** Points in the local space of the entity transform */
+    UPROPERTY()
+    TArray<FVector3f> Points;
+
+    UPROPERTY()
+    float VolumePerPoint = 0.0f;
+
+    UPROPERTY()
+    float SubmersionHeight = 1.0f;
+
+    /** Distance of the furthest point from the origin, used for the approximate inertia */
+    UPROPERTY()
+    float BoundingRadius = 1.0f;
+};
+
+/** Tuning of a floating entity type, copied from the WaterPhysicsComponent of its actor class */
+USTRUCT()
+struct FBuoyancyMassParametersFragment : public FMassConstSharedFragment
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    float WaterDensity = 1000.0f;
+
+    UPROPERTY()
+    float BuoyancyForceMultiplier = 1.0f;
+
+    UPROPERTY()
+    float LinearDamping = 2.0f;
+
+    UPROPERTY()
+    float AngularDamping = 10.0f;
+
+    UPROPERTY()
+    float QuadraticDrag = 0.001f;
+
+    UPROPERTY()
+    float SlammingCoefficient = 1.0f;
+
+    UPROPERTY()
+    float Mass = 100.0f;
+
+    /** Spawned in place of the entity when a player gets within UpgradeDistance */
+    UPROPERTY()
+    TSubclassOf<AActor> ActorClass;
+
+    /** Zero keeps the entity lightweight forever */
+    UPROPERTY()
+    float UpgradeDistance = 0.0f;
+};
+
+/** Rigid body state integrated by the buoyancy processor in place of a physics body */
+USTRUCT()
+struct FBuoyancyMassStateFragment : public FMassFragment
+{
+    GENERATED_BODY()
+
+    FVector LinearVelocity = FVector::ZeroVector;
+
+    /** In radians per second */
+    FVector AngularVelocity = FVector::ZeroVector;
+
+    /** Force and torque about the entity origin accumulated this frame */
+    FVector Force = FVector::ZeroVector;
+    FVector Torque = FVector::ZeroVector;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "BuoyancyMassProcessor.generated.h"
+
+/**
+ * Runs the component's per-point buoyancy over chunks of floating entities and integrates their
+ * transforms. Entities of a chunk share their point set and tuning, so the inner loop only touches
+ * the transform and state arrays.
+ */
+UCLASS()
+class BOUYANCYPLUGIN_API UBuoyancyMassProcessor : public UMassProcessor
+{
+    GENERATED_BODY()
+
+public:
+    UBuoyancyMassProcessor();
+
+protected:
+    virtual void ConfigureQueries() override;
+    virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+    FMassEntityQuery EntityQuery;
+};
+
+/** Replaces floating entities near a player viewpoint with their simulating actor */
+UCLASS()
+class BOUYANCYPLUGIN_API UBuoyancyMassUpgradeProcessor : public UMassProcessor
+{
+    GENERATED_BODY()
+
+public:
+    UBuoyancyMassUpgradeProcessor();
+
+protected:
+    virtual void ConfigureQueries() override;
+    virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+    FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "Templates/SubclassOf.h"
+#include "BuoyancyMassTrait.generated.h"
+
+class AActor;
+
+/**
+ * Floats Mass entities without actors or physics bodies. The buoyancy points come from the root
+ * collision of ActorClass, or from its first floating collision placed by its relative transform when
+ * the root is not one. The tuning, including the per-point drag and slamming, comes from its default
+ * WaterPhysicsComponent, so the entity hits the water like the actor it upgrades to.
+ */
+UCLASS(meta = (DisplayName = "Buoyancy"))
+class BOUYANCYPLUGIN_API UBuoyancyMassTrait : public UMassEntityTraitBase
+{
+    GENERATED_BODY()
+
+public:
+    /** Actor the entity is built from and upgrades to. Its root component should be the floating collision */
+    UPROPERTY(EditAnywhere, Category = "Buoyancy")
+    TSubclassOf<AActor> ActorClass;
+
+    UPROPERTY(EditAnywhere, Category = "Buoyancy", meta = (ClampMin = "0.01"))
+    float Mass = 100.0f;
+
+    /** Swap the entity for ActorClass when a player viewpoint gets this close. Zero never upgrades */
+    UPROPERTY(EditAnywhere, Category = "Buoyancy", meta = (ClampMin = "0.0"))
+    float UpgradeDistance = 5000.0f;
+
+protected:
+    virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+};
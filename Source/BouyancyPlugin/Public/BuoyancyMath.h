@@ -0,0 +1,173 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Submersion and force math shared by the component, the point budget tuner and the Mass processor */
+namespace BuoyancyMath
+{
+    /** Volume of a point that is Depth below the surface, ramping in over SubmersionHeight */
+    FORCEINLINE float GetSubmergedVolume(float Depth, float VolumePerPoint, float SubmersionHeight)
+    {
+        return VolumePerPoint * FMath::Clamp(Depth / SubmersionHeight, 0.0f, 1.0f);
+    }
+
+    /** Upwards force for a submerged volume */
+    FORCEINLINE float GetBuoyancyForce(float SubmergedVolume, float WaterDensity, float BuoyancyForceMultiplier)
+    {
+        return (SubmergedVolume / 1000.0f) * 9.8f * BuoyancyForceMultiplier * WaterDensity;
+    }
+
+    /** Linear and quadratic drag on a point moving through the water it displaces, WaterMass being that water's mass */
+    FORCEINLINE FVector3f GetDragForce(const FVector3f& Velocity, float WaterMass, float LinearDrag, float QuadraticDrag)
+    {
+        return -Velocity * WaterMass * (LinearDrag + QuadraticDrag * Velocity.Size());
+    }
+
+    /** Upwards force of a point entering the water: the momentum of the water it starts to displace while it ramps in over SubmersionHeight */
+    FORCEINLINE float GetSlammingForce(float VerticalVelocity, float FullWaterMass, float SubmersionHeight, float SlammingCoefficient)
+    {
+        return VerticalVelocity < 0.0f ? SlammingCoefficient * FullWaterMass * FMath::Square(VerticalVelocity) / SubmersionHeight : 0.0f;
+    }
+
+    /**
+     * Largest slamming force on a body: together with its other upwards force and gravity, slamming may at most stop
+     * the entering points' share of the body's momentum within DeltaTime, so it never throws the body back out
+     */
+    FORCEINLINE float GetMaxSlammingForce(float EnteringSpeedVolume, float TotalVolume, float UpwardForce, float Mass, float GravityZ, float DeltaTime)
+    {
+        if (TotalVolume <= 0.0f || DeltaTime <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        const float EnteringMomentum = Mass * EnteringSpeedVolume / TotalVolume;
+        return FMath::Max(EnteringMomentum / DeltaTime - (UpwardForce + Mass * GravityZ), 0.0f);
+    }
+
+    /** One body's points moved into a float frame, one array per axis so the force pass streams through them */
+    struct FPointFrame
+    {
+        TArray<float> X;
+        TArray<float> Y;
+        TArray<float> Z;
+
+        /** Water height above the frame origin at each point, filled by the water query */
+        TArray<float> WaterHeight;
+
+        int32 Num() const { return X.Num(); }
+    };
+
+    /** Body state and tuning for the per-point forces, positions and velocities in the frame */
+    struct FPointForceParams
+    {
+        FVector3f CenterOfMass = FVector3f::ZeroVector;
+        FVector3f LinearVelocity = FVector3f::ZeroVector;
+        FVector3f AngularVelocity = FVector3f::ZeroVector;
+        float VolumePerPoint = 0.0f;
+        float SubmersionHeight = 1.0f;
+        float WaterDensity = 1000.0f;
+        float BuoyancyForceMultiplier = 1.0f;
+        float GravityMagnitude = 980.0f;
+        float LinearDrag = 0.0f;
+        float QuadraticDrag = 0.0f;
+        float SlammingCoefficient = 0.0f;
+    };
+
+    /** Sums of the per-point forces, torques are about the centre of mass */
+    struct FPointForceResult
+    {
+        /** Buoyancy and drag */
+        FVector3f Force = FVector3f::ZeroVector;
+        FVector3f Torque = FVector3f::ZeroVector;
+
+        /** Kept apart so the caller can limit it */
+        FVector3f SlammingForce = FVector3f::ZeroVector;
+        FVector3f SlammingTorque = FVector3f::ZeroVector;
+
+        /** Downward speed of the points entering the water weighted by their volume, bounds the slamming */
+        float EnteringSpeedVolume = 0.0f;
+
+        float SubmergedVolume = 0.0f;
+        int32 NumSubmerged = 0;
+    };
+
+    /**
+     * Origin of a float frame at the location, level with the water body. Points and water heights relative
+     * to it stay small enough for floats however far the water is from the world origin
+     */
+    FORCEINLINE FVector GetWaterFrameOrigin(const FVector& WorldLocation, double WaterLevel)
+    {
+        return FVector(WorldLocation.X, WorldLocation.Y, WaterLevel);
+    }
+
+    /**
+     * Fills the water height above FrameOrigin at every point of the frame. SampleWaterHeight takes a world
+     * location and returns the world height as a double; the origin is subtracted before narrowing to float,
+     * a far away height would lose its precision as a float first
+     */
+    template <typename SamplerType>
+    void SampleWaterHeightsInFrame(const FVector& FrameOrigin, FPointFrame& Frame, SamplerType&& SampleWaterHeight)
+    {
+        for (int32 i = 0; i < Frame.Num(); i++)
+        {
+            const FVector WorldLocation = FrameOrigin + FVector(Frame.X[i], Frame.Y[i], Frame.Z[i]);
+            Frame.WaterHeight[i] = (float)(SampleWaterHeight(WorldLocation) - FrameOrigin.Z);
+        }
+    }
+
+    /** Moves body-local points into the frame, LocalTransform being the body transform relative to the frame origin */
+    inline void TransformPoints(const FTransform3f& LocalTransform, TArrayView<const FVector3f> Points, FPointFrame& OutFrame)
+    {
+        const int32 NumPoints = Points.Num();
+        OutFrame.X.SetNumUninitialized(NumPoints);
+        OutFrame.Y.SetNumUninitialized(NumPoints);
+        OutFrame.Z.SetNumUninitialized(NumPoints);
+        OutFrame.WaterHeight.SetNumUninitialized(NumPoints);
+
+        for (int32 i = 0; i < NumPoints; i++)
+        {
+            const FVector3f Point = LocalTransform.TransformPosition(Points[i]);
+            OutFrame.X[i] = Point.X;
+            OutFrame.Y[i] = Point.Y;
+            OutFrame.Z[i] = Point.Z;
+        }
+    }
+
+    /** Adds the buoyancy, drag and slamming of every submerged point of the frame to Result */
+    inline void AccumulatePointForces(const FPointFrame& Frame, const FPointForceParams& Params, FPointForceResult& Result)
+    {
+        const float FullWaterMass = GetBuoyancyForce(Params.VolumePerPoint, Params.WaterDensity, Params.BuoyancyForceMultiplier) / Params.GravityMagnitude;
+
+        for (int32 i = 0; i < Frame.Num(); i++)
+        {
+            const float Depth = Frame.WaterHeight[i] - Frame.Z[i];
+
+            if (Depth <= 0.0f)
+            {
+                continue;
+            }
+
+            const float SubmergedVolume = GetSubmergedVolume(Depth, Params.VolumePerPoint, Params.SubmersionHeight);
+            const float BuoyancyForce = GetBuoyancyForce(SubmergedVolume, Params.WaterDensity, Params.BuoyancyForceMultiplier);
+
+            const FVector3f Arm = FVector3f(Frame.X[i], Frame.Y[i], Frame.Z[i]) - Params.CenterOfMass;
+            const FVector3f PointVelocity = Params.LinearVelocity + FVector3f::CrossProduct(Params.AngularVelocity, Arm);
+            const FVector3f PointForce = FVector3f(0.0f, 0.0f, BuoyancyForce)
+                + GetDragForce(PointVelocity, BuoyancyForce / Params.GravityMagnitude, Params.LinearDrag, Params.QuadraticDrag);
+
+            Result.Force += PointForce;
+            Result.Torque += FVector3f::CrossProduct(Arm, PointForce);
+            Result.SubmergedVolume += SubmergedVolume;
+            Result.NumSubmerged++;
+
+            // Only points still ramping in are entering the water
+            if (Depth < Params.SubmersionHeight)
+            {
+                const FVector3f PointSlamming = FVector3f(0.0f, 0.0f, GetSlammingForce(PointVelocity.Z, FullWaterMass, Params.SubmersionHeight, Params.SlammingCoefficient));
+                Result.SlammingForce += PointSlamming;
+                Result.SlammingTorque += FVector3f::CrossProduct(Arm, PointSlamming);
+                Result.EnteringSpeedVolume += Params.VolumePerPoint * FMath::Max(-PointVelocity.Z, 0.0f);
+            }
+        }
+    }
+}
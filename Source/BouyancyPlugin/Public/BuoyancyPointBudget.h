@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+class USceneComponent;
+class UWaterPhysicsComponent;
+
+/** Cost and accuracy of one PointsPerAxis setting over every primitive that was tuned */
+struct FBuoyancyPointBudgetSample
+{
+    int32 PointsPerAxis = 0;
+    int32 NumPoints = 0;
+
+    /** Worst equilibrium draft error, as a fraction of the shape size */
+    float DraftError = 0.0f;
+
+    /** Worst equilibrium tilt error, in degrees */
+    float TiltError = 0.0f;
+
+    bool bWithinTolerance = false;
+};
+
+struct FBuoyancyPointBudgetResult
+{
+    /** Setting the component was using before tuning */
+    FBuoyancyPointBudgetSample Current;
+
+    /** Cheapest setting within tolerance, or the most accurate one when none is */
+    FBuoyancyPointBudgetSample Best;
+
+    TArray<FBuoyancyPointBudgetSample> Samples;
+
+    /** Names of the primitives the samples were measured on */
+    TArray<FString> TunedPrimitives;
+
+    int32 NumPrimitives = 0;
+
+    bool IsValid() const { return NumPrimitives > 0 && Samples.Num() > 0; }
+};
+
+/**
+ * Picks the cheapest PointsPerAxis for a set of collision primitives. Each primitive is dropped
+ * slightly off level onto flat water and settled to its static equilibrium, once with the buoyancy
+ * points and once with a dense voxel reference of its collision shape, and the resulting draft and
+ * tilt are compared.
+ */
+class BOUYANCYPLUGIN_API FBuoyancyPointBudgetTuner
+{
+public:
+    /** Parents of component templates that are not attached yet, such as construction script nodes */
+    using FAttachParentMap = TMap<const USceneComponent*, const USceneComponent*>;
+
+    /** Uses the tolerances, density and point range of the component */
+    explicit FBuoyancyPointBudgetTuner(const UWaterPhysicsComponent* WaterPhysics);
+
+    /** Tunes the primitives the component floats at runtime, the others are skipped */
+    FBuoyancyPointBudgetResult Tune(const TArray<UPrimitiveComponent*>& Primitives, const FAttachParentMap& AttachParents = FAttachParentMap()) const;
+
+    /**
+     * Same rule as the component's body discovery: primitives that simulate or weld to a simulating parent,
+     * otherwise the first box, sphere, capsule or static mesh, which the component makes simulate
+     */
+    static void GetFloatedPrimitives(const TArray<UPrimitiveComponent*>& Primitives, const FAttachParentMap& AttachParents, TArray<UPrimitiveComponent*>& OutFloated);
+
+private:
+    /** Fraction of the shape under water at equilibrium, from the primitive's mass */
+    float GetSubmergedFraction(UPrimitiveComponent* Primitive, float ShapeVolume) const;
+
+    float DraftTolerance = 0.05f;
+    float TiltTolerance = 2.0f;
+    int32 CurrentPointsPerAxis = 3;
+    int32 MaxPointsPerAxis = 8;
+    float WaterDensity = 1000.0f;
+    float BuoyancyForceMultiplier = 1.0f;
+};
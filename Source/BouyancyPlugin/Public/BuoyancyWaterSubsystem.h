@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WaterBodyActor.h"
+#include "BuoyancyMath.h"
+#include "BuoyancyWaterSubsystem.generated.h"
+
+/**
+ * Caches the water bodies of a world and their bounds so buoyancy doesn't have to iterate actors
+ * for every water query, and keeps count of the buoyancy components that are currently in water.
+ */
+UCLASS()
+class UBuoyancyWaterSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    void RefreshWaterBodies();
+
+    /** Water surface height including waves, or -99999 when there is no water */
+    float GetWaterHeightAtLocation(const FVector& WorldLocation) const;
+
+    /** Water body under the location, INDEX_NONE without water. Resolve it once and pass it to the frame queries below */
+    int32 FindWaterBodyIndex(const FVector& WorldLocation) const;
+
+    /**
+     * Origin of a local frame at the location, level with the water body. Points and water heights
+     * relative to it stay small enough for floats however far the water is from the world origin.
+     */
+    FVector GetWaterFrameOrigin(int32 WaterBodyIndex, const FVector& WorldLocation) const;
+
+    /** Whether the location lies inside the cached XY bounds of the water body, FindWaterBodyIndex also falls back to water elsewhere */
+    bool IsInsideWaterBody(int32 WaterBodyIndex, const FVector& WorldLocation) const;
+
+    /** Water surface height including waves, sampled from a water body resolved with FindWaterBodyIndex */
+    float GetWaterHeightAtLocation(int32 WaterBodyIndex, const FVector& WorldLocation) const;
+
+    /** Fills the water height above FrameOrigin at every point of the frame, all sampled from one water body */
+    void GetWaterHeightsInFrame(int32 WaterBodyIndex, const FVector& FrameOrigin, BuoyancyMath::FPointFrame& Frame) const;
+
+    /** Whether the box touches the cached bounds of any water body */
+    bool IsNearWater(const FBox& Bounds) const;
+
+    void SetBuoyancyActive(bool bActive);
+
+    UFUNCTION(BlueprintCallable, Category = "Buoyancy")
+    int32 GetNumActiveBuoyancyComponents() const { return NumActiveBuoyancyComponents; }
+
+private:
+    UPROPERTY()
+    TArray<AWaterBody*> WaterBodies;
+
+    TArray<FBox> WaterBodyBounds;
+
+    int32 NumActiveBuoyancyComponents = 0;
+
+    FDelegateHandle ActorSpawnedHandle;
+
+    double GetWaterSurfaceHeight(AWaterBody* WaterBody, const FVector& WorldLocation, float Time) const;
+    void AddWaterBody(AWaterBody* WaterBody);
+    void OnActorSpawned(AActor* SpawnedActor);
+};
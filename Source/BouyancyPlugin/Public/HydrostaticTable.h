@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "PhysicsEngine/AggregateGeom.h"
+#include "HydrostaticTable.generated.h"
+
+/**
+ * Baked hydrostatic data for a rigid shape: submerged volume and centre of buoyancy
+ * sampled over (draft, pitch, roll). Draft is the height of the water plane above the
+ * body origin along the plane normal, pitch and roll are the body's rotation relative
+ * to the water plane. Stored as asset user data on the mesh or component it was baked from.
+ */
+UCLASS()
+class UHydrostaticTable : public UAssetUserData
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    int32 DraftSteps = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    int32 PitchSteps = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    int32 RollSteps = 0;
+
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    float MinDraft = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    float MaxDraft = 0.0f;
+
+    UPROPERTY(VisibleAnywhere, Category = "Hydrostatics")
+    float TotalVolume = 0.0f;
+
+    /** Submerged volume per entry, indexed by GetIndex(Draft, Pitch, Roll) */
+    UPROPERTY()
+    TArray<float> Volumes;
+
+    /** Centre of buoyancy per entry, in the unscaled local space of the shape */
+    UPROPERTY()
+    TArray<FVector3f> Centres;
+
+    void Bake(const FKAggregateGeom& AggGeom, int32 InDraftSteps, int32 InPitchSteps, int32 InRollSteps, int32 VoxelResolution);
+    bool Lookup(float Draft, float Pitch, float Roll, float& OutVolume, FVector& OutCentre) const;
+    bool IsBaked() const;
+
+    /** Centres of the grid cells inside the shape, in its unscaled local space. Returns the cell size, zero when the shape has no collision */
+    static FVector Voxelize(const FKAggregateGeom& AggGeom, int32 VoxelResolution, TArray<FVector>& OutCells);
+
+private:
+    int32 GetIndex(int32 Draft, int32 Pitch, int32 Roll) const
+    {
+        return (Roll * PitchSteps + Pitch) * DraftSteps + Draft;
+    }
+};
@@ -9,19 +9,132 @@
 #include "WaterBodyActor.h"
 #include "WaterBodyComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PhysicsEngine/AggregateGeom.h"
 #include "Engine/World.h"
+#include "Engine/NetSerialization.h"
+#include "BuoyancyMath.h"
 #include "WaterPhysicsComponent.generated.h"
 
+/** Debug drawing and per-tick logging, compiled out of server and shipping builds */
+#ifndef BUOYANCY_WITH_DEBUG
+#define BUOYANCY_WITH_DEBUG (!UE_SERVER && !UE_BUILD_SHIPPING)
+#endif
+
+class UHydrostaticTable;
+class UBuoyancyWaterSubsystem;
+
+UENUM()
+enum class EBuoyancyShape : uint8
+{
+    Box,
+    Sphere,
+    Capsule,
+    StaticMesh,
+    PhysicsAssetBody
+};
+
+/** One rigid part floated by the component: a collision primitive or a body of a skeletal mesh's physics asset */
+USTRUCT()
+struct FBuoyancyBody
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UPrimitiveComponent* Component = nullptr;
+
+    /** Index into the skeletal mesh's Bodies, INDEX_NONE for plain primitives */
+    int32 BodyIndex = INDEX_NONE;
+
+    EBuoyancyShape Shape = EBuoyancyShape::Box;
+
+    /** Range of this body's points in the flattened BuoyancyPoints array, in the body's local space */
+    int32 FirstPoint = 0;
+    int32 NumPoints = 0;
+
+    float VolumePerPoint = 0.0f;
+    float SubmersionHeight = 1.0f;
+
+    UPROPERTY()
+    UHydrostaticTable* HydrostaticTable = nullptr;
+
+    /** Buoyancy and drag about the centre of mass accumulated this tick, slamming and rotational drag are added per simulated body */
+    FVector Force = FVector::ZeroVector;
+    FVector Torque = FVector::ZeroVector;
+};
+
+/** Instances of an instanced static mesh floated analytically, without rigid bodies. Per-instance state is kept in parallel arrays */
+USTRUCT()
+struct FFloatingInstanceSet
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UInstancedStaticMeshComponent* Component = nullptr;
+
+    /** Transforms the instances started from relative to the component, their X, Y, yaw and scale are kept */
+    TArray<FTransform> RestTransforms;
+
+    TArray<float> Heave;
+    TArray<float> HeaveVelocity;
+    TArray<float> Pitch;
+    TArray<float> PitchVelocity;
+    TArray<float> Roll;
+    TArray<float> RollVelocity;
+
+    /** Instances handed over to a simulating component, hidden with a zero scale */
+    TBitArray<> Promoted;
+
+    /** Current transforms of the instances relative to the component */
+    TArray<FTransform> InstanceTransforms;
+
+    /** Scratch buffer for one contiguous run of updated instances, handed to BatchUpdateInstancesTransforms */
+    TArray<FTransform> DirtyTransforms;
+
+    /** Unscaled half size of the mesh in X and Y, used to place the pitch and roll water samples */
+    FVector2D HalfExtent = FVector2D::ZeroVector;
+
+    /** Unscaled height of the resting waterline above the mesh origin */
+    float WaterlineOffset = 0.0f;
+
+    /** Water body the last instance was over, neighbouring instances usually share it */
+    int32 WaterBodyIndex = INDEX_NONE;
+};
+
+/** Authoritative state of the owner's root body, sent to clients at the server buoyancy rate */
+USTRUCT()
+struct FBuoyancyReplicatedState
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize100 Location;
+
+    UPROPERTY()
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    UPROPERTY()
+    FVector_NetQuantize10 LinearVelocity;
+
+    /** Server world time the state was taken at */
+    UPROPERTY()
+    float ServerTime = 0.0f;
+};
+
 UCLASS(ClassGroup=(Physics), meta=(BlueprintSpawnableComponent))
-class UWaterPhysicsComponent : public UActorComponent
+class BOUYANCYPLUGIN_API UWaterPhysicsComponent : public UActorComponent
 {
     GENERATED_BODY()
 
 public:
     UWaterPhysicsComponent();
 
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, 
                               FActorComponentTickFunction* ThisTickFunction) override;
 
@@ -35,14 +148,120 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Box Collision", meta = (ClampMin = "2"))
     int32 PointsPerAxis = 3;
     
+    /** Linear drag per submerged point, scaled by the water it displaces. A body floating at rest is damped by about LinearDamping times its mass */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damping", meta = (ClampMin = "0.0"))
     float LinearDamping = 2.f;
     
+    /** Rotational drag on top of the per-point drag, scaled by how much of the body is submerged */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damping", meta = (ClampMin = "0.0"))
     float AngularDamping = 10.f;
+    
+    /** Drag per submerged point growing with the square of its speed, per cm/s */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damping", meta = (ClampMin = "0.0"))
+    float QuadraticDrag = 0.001f;
+    
+    /** Scale of the upwards force on points entering the water, 0 turns slamming off */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damping", meta = (ClampMin = "0.0"))
+    float SlammingCoefficient = 1.0f;
+
+    /** Use the baked hydrostatic table instead of per-point sampling when one is available */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hydrostatics")
+    bool bUseHydrostaticTable = true;
+
+    UPROPERTY(EditAnywhere, Category = "Hydrostatics", meta = (ClampMin = "2"))
+    int32 HydrostaticDraftSteps = 16;
+
+    UPROPERTY(EditAnywhere, Category = "Hydrostatics", meta = (ClampMin = "2"))
+    int32 HydrostaticPitchSteps = 13;
+
+    UPROPERTY(EditAnywhere, Category = "Hydrostatics", meta = (ClampMin = "4"))
+    int32 HydrostaticRollSteps = 24;
+
+    UPROPERTY(EditAnywhere, Category = "Hydrostatics", meta = (ClampMin = "4"))
+    int32 HydrostaticVoxelResolution = 32;
+
+    /** Bakes displaced volume and centre of buoyancy over (draft, pitch, roll) and stores it on the mesh or collision component */
+    UFUNCTION(CallInEditor, Category = "Hydrostatics")
+    void BakeHydrostaticTable();
+
+    /** Largest draft error the point budget tuner accepts, as a fraction of the shape size */
+    UPROPERTY(EditAnywhere, Category = "Point Budget", meta = (ClampMin = "0.0"))
+    float PointBudgetDraftTolerance = 0.05f;
+
+    /** Largest equilibrium tilt error the point budget tuner accepts, in degrees */
+    UPROPERTY(EditAnywhere, Category = "Point Budget", meta = (ClampMin = "0.0"))
+    float PointBudgetTiltTolerance = 2.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Point Budget", meta = (ClampMin = "2"))
+    int32 MaxPointsPerAxis = 8;
+
+    /** Settles every collision on flat water against a voxel reference and sets Points Per Axis to the cheapest value within tolerance */
+    UFUNCTION(CallInEditor, Category = "Point Budget")
+    void TunePointBudget();
+
+    /**
+     * Float instanced static mesh instances with a spring-damper model instead of rigid bodies.
+     * Instances attached under a simulating body ride along with it and are never floated
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating")
+    bool bFloatInstances = false;
+
+    /** Fraction of the mesh height below the water at rest */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float InstanceDraftRatio = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0"))
+    float InstanceHeaveStiffness = 20.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0"))
+    float InstanceHeaveDamping = 4.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0"))
+    float InstanceTiltStiffness = 15.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0"))
+    float InstanceTiltDamping = 4.f;
+
+    /** Turn instances into simulating bodies when something hits them. Needs collision enabled on the instanced mesh */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating")
+    bool bPromoteInstancesOnHit = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Instanced Floating", meta = (ClampMin = "0.0"))
+    float InstancePromotionRadius = 50.f;
+
+    /** Replaces an instance with a simulating static mesh component that is floated with buoyancy points */
+    UFUNCTION(BlueprintCallable, Category = "Instanced Floating")
+    UStaticMeshComponent* PromoteInstance(UInstancedStaticMeshComponent* InstancedMesh, int32 InstanceIndex);
+
+    /** Only tick while the actor is overlapping or close to a water body */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Activation")
+    bool bActivateNearWater = true;
+
+    /** Seconds between checks of the actor bounds against the cached water body bounds */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Activation", meta = (ClampMin = "0.05"))
+    float ProximityCheckInterval = 0.5f;
+
+    /** Distance added around the actor bounds before testing them against the water bodies */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Activation", meta = (ClampMin = "0.0"))
+    float WaterProximityMargin = 200.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Activation")
+    bool bIsInWater = false;
+
+    /** Seconds between buoyancy updates on dedicated servers, the skipped frames are applied as impulses. Zero updates every frame */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0.0"))
+    float ServerTickInterval = 0.05f;
+
+    /** Send the root body state to clients, which follow it instead of simulating. Needs Replicate Movement off and a single simulated body */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking")
+    bool bReplicateBuoyancyState = false;
+
+    /** How far in the past clients render the server state, should cover a couple of server updates */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Networking", meta = (ClampMin = "0.0"))
+    float ClientInterpolationDelay = 0.1f;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
-    bool bShowDebug = true;
+    bool bShowDebug = false;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Debug")
     bool bIsStaticMesh = false;
@@ -57,22 +276,89 @@ public:
     bool bIsCapsule = false;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
-    bool bShowDetailedLogs = true;
+    bool bShowDetailedLogs = false;
+
+    /** Box, sphere, capsule or static mesh collision that gets buoyancy points */
+    static bool IsBuoyancyPrimitive(const UPrimitiveComponent* Component);
+
+    /** Builds the collision shape of a primitive in its unscaled local space, and returns the object its hydrostatic table lives on */
+    static UObject* GetHydrostaticShape(UPrimitiveComponent* Component, FKAggregateGeom& OutAggGeom);
+
+    /** Appends the local buoyancy points of a primitive for a points per axis setting. Returns false for unsupported or meshless primitives */
+    static bool BuildPrimitivePointSet(const UPrimitiveComponent* Component, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints,
+                                       float& OutVolumePerPoint, float& OutSubmersionHeight);
 
 private:
+    /** Unscaled local points of every body, single precision is plenty in local space */
     UPROPERTY()
-    TArray<FVector> BuoyancyPoints;
+    TArray<FVector3f> BuoyancyPoints;
+
+    /** Scratch for the points of the body being floated, moved into its water frame */
+    BuoyancyMath::FPointFrame PointFrame;
 
     UPROPERTY()
-    UPrimitiveComponent* PhysicsComp = nullptr;
+    TArray<FBuoyancyBody> BuoyancyBodies;
+
+    UPROPERTY()
+    TArray<FFloatingInstanceSet> FloatingInstanceSets;
+
+    UPROPERTY()
+    UBuoyancyWaterSubsystem* WaterSubsystem = nullptr;
+
+    FTimerHandle ProximityTimerHandle;
+
+    UPROPERTY(ReplicatedUsing = OnRep_ReplicatedState)
+    FBuoyancyReplicatedState ReplicatedState;
+
+    /** Last states received from the server, oldest first */
+    TArray<FBuoyancyReplicatedState> ReceivedStates;
+
+    /** Set on dedicated servers running at ServerTickInterval */
+    bool bApplyAsImpulse = false;
+
+    /** Set when bReplicateBuoyancyState is on and the owner can use it */
+    bool bReplicatingState = false;
+
+    /** Set on clients that follow ReplicatedState instead of simulating */
+    bool bFollowServerState = false;
     
-    void GenerateBuoyancyPoints();
-    void GenerateBoxBuoyancyPoints();
-    void GenerateSphereBuoyancyPoints();
-    void GenerateStaticMeshBuoyancyPoints();
-    void GenerateCapsuleBuoyancyPoints();
+    void DiscoverBuoyancyBodies();
+    void AddFloatingInstances(UInstancedStaticMeshComponent* InstancedMesh);
+    void UpdateFloatingInstances(float DeltaTime);
+
+    void UpdateWaterActivation();
+    void SetInWater(bool bInWater);
+
+    bool CanReplicateBuoyancyState() const;
+    void UpdateReplicatedState();
+    void FollowServerState();
+
+    UFUNCTION()
+    void OnRep_ReplicatedState();
+
+    UFUNCTION()
+    void OnOwnerBeginOverlap(AActor* OverlappedActor, AActor* OtherActor);
+
+    UFUNCTION()
+    void OnOwnerEndOverlap(AActor* OverlappedActor, AActor* OtherActor);
+
+    UFUNCTION()
+    void OnInstancedMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+                            FVector NormalImpulse, const FHitResult& Hit);
+    void AddPrimitiveBody(UPrimitiveComponent* Component);
+    void AddPhysicsAssetBodies(USkeletalMeshComponent* SkeletalMeshComponent);
+    static void GenerateBoxBuoyancyPoints(const FVector& BoxExtent, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints);
+    static void GenerateSphereBuoyancyPoints(float SphereRadius, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints);
+    static bool BuildAggGeomPointSet(const FKAggregateGeom& AggGeom, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints,
+                                     float& OutVolumePerPoint, float& OutSubmersionHeight);
+    static void GenerateAggGeomBuoyancyPoints(const FKAggregateGeom& AggGeom, TArray<FVector3f>& OutPoints);
+    static void GenerateCapsuleBuoyancyPoints(float CapsuleRadius, float CapsuleHalfHeight, int32 InPointsPerAxis, TArray<FVector3f>& OutPoints);
+    FBodyInstance* GetTargetBodyInstance(const FBuoyancyBody& Body) const;
+    FTransform GetBodyTransform(const FBuoyancyBody& Body) const;
     void ApplyBuoyancy(float DeltaTime);
-    void ApplyDampingForces(float DeltaTime) const;
+    void ApplyHydrostaticBuoyancy(FBuoyancyBody& Body, const FBodyInstance* TargetBody, const FVector& CenterOfMass,
+                                  float& InOutSubmergedVolume, float& InOutTotalVolume);
     float GetWaterHeightAtLocation(const FVector& WorldLocation) const;
+    void DrawAggGeom(const FKAggregateGeom& AggGeom, const FTransform& BodyTransform) const;
     void DrawDebugInfo();
 };
\ No newline at end of file
@@ -0,0 +1,5 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BouyancyPluginEditor.h"
+
+IMPLEMENT_MODULE(FBouyancyPluginEditorModule, BouyancyPluginEditor)
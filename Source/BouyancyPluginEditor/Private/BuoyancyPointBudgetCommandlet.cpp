@@ -0,0 +1,190 @@
+#include "BuoyancyPointBudgetCommandlet.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "BuoyancyPointBudget.h"
+#include "Engine/Blueprint.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "FileHelpers.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "WaterPhysicsComponent.h"
+
+UBuoyancyPointBudgetCommandlet::UBuoyancyPointBudgetCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Tunes Points Per Axis of every WaterPhysicsComponent in Blueprints and reports the cost savings");
+    HelpParamNames.Add(TEXT("Path"));
+    HelpParamDescriptions.Add(TEXT("Content path to search, /Game by default"));
+    HelpParamNames.Add(TEXT("Report"));
+    HelpParamDescriptions.Add(TEXT("CSV file to write, Saved/BuoyancyPointBudget.csv by default"));
+    HelpParamNames.Add(TEXT("NoSave"));
+    HelpParamDescriptions.Add(TEXT("Only write the report, leave the Blueprints untouched"));
+}
+
+/**
+ * Native components of the class default object and the Blueprint's own construction script templates.
+ * Construction script templates are not attached, their parents come from the node tree instead
+ */
+static void GetComponentTemplates(UBlueprint* Blueprint, TArray<UActorComponent*>& OutTemplates, FBuoyancyPointBudgetTuner::FAttachParentMap& OutAttachParents)
+{
+    AActor* DefaultActor = Cast<AActor>(Blueprint->GeneratedClass->GetDefaultObject());
+
+    if (DefaultActor)
+    {
+        DefaultActor->GetComponents(OutTemplates);
+    }
+
+    if (Blueprint->SimpleConstructionScript)
+    {
+        for (USCS_Node* Node : Blueprint->SimpleConstructionScript->GetAllNodes())
+        {
+            if (!Node || !Node->ComponentTemplate)
+            {
+                continue;
+            }
+
+            OutTemplates.AddUnique(Node->ComponentTemplate);
+
+            for (USCS_Node* ChildNode : Node->GetChildNodes())
+            {
+                if (ChildNode && ChildNode->ComponentTemplate)
+                {
+                    OutAttachParents.Add(Cast<USceneComponent>(ChildNode->ComponentTemplate), Cast<USceneComponent>(Node->ComponentTemplate));
+                }
+            }
+
+            // Top level nodes can hang under a native component of the class
+            if (DefaultActor && Node->bIsParentComponentNative && Node->ParentComponentOrVariableName != NAME_None)
+            {
+                for (UActorComponent* NativeComponent : DefaultActor->GetComponents())
+                {
+                    if (NativeComponent && NativeComponent->GetFName() == Node->ParentComponentOrVariableName)
+                    {
+                        OutAttachParents.Add(Cast<USceneComponent>(Node->ComponentTemplate), Cast<USceneComponent>(NativeComponent));
+                    }
+                }
+            }
+        }
+    }
+}
+
+int32 UBuoyancyPointBudgetCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamValues;
+    ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+    const bool bSave = !Switches.Contains(TEXT("NoSave"));
+    const FString SearchPath = ParamValues.Contains(TEXT("Path")) ? ParamValues[TEXT("Path")] : TEXT("/Game");
+    const FString ReportPath = ParamValues.Contains(TEXT("Report")) ? ParamValues[TEXT("Report")] : FPaths::ProjectSavedDir() / TEXT("BuoyancyPointBudget.csv");
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+    AssetRegistry.SearchAllAssets(true);
+
+    FARFilter Filter;
+    Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+    Filter.PackagePaths.Add(FName(*SearchPath));
+    Filter.bRecursiveClasses = true;
+    Filter.bRecursivePaths = true;
+
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssets(Filter, Assets);
+
+    FString Report = TEXT("Asset,Primitives,TunedPrimitives,OldPointsPerAxis,OldPoints,NewPointsPerAxis,NewPoints,Savings,DraftError,TiltError,WithinTolerance\n");
+    TArray<UPackage*> PackagesToSave;
+    int32 TunedAssets = 0;
+    int64 TotalOldPoints = 0;
+    int64 TotalNewPoints = 0;
+
+    for (const FAssetData& Asset : Assets)
+    {
+        UBlueprint* Blueprint = Cast<UBlueprint>(Asset.GetAsset());
+
+        if (!Blueprint || !Blueprint->GeneratedClass || !Blueprint->GeneratedClass->IsChildOf(AActor::StaticClass()))
+        {
+            continue;
+        }
+
+        TArray<UActorComponent*> Templates;
+        FBuoyancyPointBudgetTuner::FAttachParentMap AttachParents;
+        GetComponentTemplates(Blueprint, Templates, AttachParents);
+
+        UWaterPhysicsComponent* WaterPhysics = nullptr;
+        TArray<UPrimitiveComponent*> Primitives;
+
+        for (UActorComponent* Template : Templates)
+        {
+            if (UWaterPhysicsComponent* WaterPhysicsTemplate = Cast<UWaterPhysicsComponent>(Template))
+            {
+                WaterPhysics = WaterPhysicsTemplate;
+            }
+            else if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Template))
+            {
+                Primitives.Add(Primitive);
+            }
+        }
+
+        if (!WaterPhysics)
+        {
+            continue;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("Tuning point budget of %s"), *Asset.GetObjectPathString());
+
+        FBuoyancyPointBudgetResult Result = FBuoyancyPointBudgetTuner(WaterPhysics).Tune(Primitives, AttachParents);
+
+        if (!Result.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT(" %s has no BoxComponent, SphereComponent, CapsuleComponent or StaticMeshComponent to tune"), *Asset.AssetName.ToString());
+            continue;
+        }
+
+        const FBuoyancyPointBudgetSample& Current = Result.Current;
+        const FBuoyancyPointBudgetSample& Best = Result.Best;
+        const float Savings = Current.NumPoints > 0 ? 1.0f - (float)Best.NumPoints / Current.NumPoints : 0.0f;
+
+        // Tuned primitives are joined with semicolons so they stay in one CSV column
+        Report += FString::Printf(TEXT("%s,%d,%s,%d,%d,%d,%d,%.1f%%,%.2f%%,%.2f,%s\n"),
+                                  *Asset.GetObjectPathString(), Result.NumPrimitives, *FString::Join(Result.TunedPrimitives, TEXT(";")),
+                                  Current.PointsPerAxis, Current.NumPoints,
+                                  Best.PointsPerAxis, Best.NumPoints, Savings * 100.0f, Best.DraftError * 100.0f, Best.TiltError,
+                                  Best.bWithinTolerance ? TEXT("yes") : TEXT("no"));
+
+        UE_LOG(LogTemp, Warning, TEXT(" Tuned on %s"), *FString::Join(Result.TunedPrimitives, TEXT(", ")));
+        UE_LOG(LogTemp, Warning, TEXT(" Points per axis %d -> %d, %d -> %d points (%.0f%% saved)"),
+               Current.PointsPerAxis, Best.PointsPerAxis, Current.NumPoints, Best.NumPoints, Savings * 100.0f);
+
+        TunedAssets++;
+        TotalOldPoints += Current.NumPoints;
+        TotalNewPoints += Best.NumPoints;
+
+        if (bSave && Best.PointsPerAxis != WaterPhysics->PointsPerAxis)
+        {
+            WaterPhysics->Modify();
+            WaterPhysics->PointsPerAxis = Best.PointsPerAxis;
+            FBlueprintEditorUtils::MarkBlueprintAsModified(Blueprint);
+            PackagesToSave.AddUnique(Blueprint->GetOutermost());
+        }
+    }
+
+    if (!FFileHelper::SaveStringToFile(Report, *ReportPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Cannot write point budget report to %s"), *ReportPath);
+    }
+
+    if (PackagesToSave.Num() > 0)
+    {
+        UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, false);
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Tuned %d Blueprints: %lld -> %lld buoyancy points, saved %d packages. Report: %s"),
+           TunedAssets, TotalOldPoints, TotalNewPoints, PackagesToSave.Num(), *ReportPath);
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BuoyancyPointBudgetCommandlet.generated.h"
+
+/**
+ * Runs the point budget tuner on every Blueprint with a WaterPhysicsComponent, writes the cheapest
+ * Points Per Axis within tolerance back to the component and saves a CSV report of the savings.
+ *
+ * UnrealEditor-Cmd.exe <Project> -run=BuoyancyPointBudget [-Path=/Game/Props] [-Report=<file.csv>] [-NoSave]
+ */
+UCLASS()
+class UBuoyancyPointBudgetCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UBuoyancyPointBudgetCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};